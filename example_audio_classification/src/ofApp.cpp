@@ -26,8 +26,11 @@ void ofApp::setup(){
 
     //Setup the plots
     magnitudePlot.setup( FFT_MAG_SIZE, 1 );
-    //spectrogramPlot.setup( SPECTROGRAM_PLOT_SIZE, FFT_MAG_SIZE );
-    spectrogramPlotBuffer.resize( SPECTROGRAM_PLOT_SIZE, VectorFloat(FFT_MAG_SIZE) );
+    magnitudePlot.setLockFreeData( true ); //The magnitude plot is refilled from the audio thread, so never block it on the draw thread
+    //The spectrogram is sized once, then each FFT hop only uploads its new column
+    spectrogramPlot.resize( FFT_MAG_SIZE, SPECTROGRAM_PLOT_SIZE );
+    spectrogramColumns.setup( SPECTROGRAM_SIZE, FFT_MAG_SIZE );
+    spectrogramColumn.resize( FFT_MAG_SIZE );
 
     trainingClassLabel = 1;
     sampleCounter = 0;
@@ -55,14 +58,10 @@ void ofApp::setup(){
 void ofApp::update(){
     //All the updates are performed in the audio callback
 
-    //Update the spectrogram plot, plot the data transposed as it looks nicer
-    MatrixFloat matrix(FFT_MAG_SIZE,SPECTROGRAM_PLOT_SIZE);
-    for(UINT i=0; i<SPECTROGRAM_PLOT_SIZE; i++){
-        for(UINT j=0; j<FFT_MAG_SIZE; j++){
-            matrix[j][i] = spectrogramPlotBuffer[i][FFT_MAG_SIZE-1-j];
-        }
+    //Scroll the spectrogram plot by the columns computed since the last frame, the texture can only be written from this thread
+    while( spectrogramColumns.pop( spectrogramFrame ) ){
+        spectrogramPlot.pushColumn( &spectrogramFrame.data[0] );
     }
-    spectrogramPlot.update( matrix );
 }
 
 //--------------------------------------------------------------
@@ -163,7 +162,12 @@ void ofApp::audioIn(float * input, int bufferSize, int nChannels){
             scaledMagData[i] = GRT::Util::scale( 20.0 * log10( rawMagData[i] + 1.0e-8 ), minValue, maxValue, 0.0, 1.0, true );
         }
         spectrogram.push_back( scaledMagData );
-        spectrogramPlotBuffer.push_back( scaledMagData );
+
+        //Queue the column for the spectrogram plot, flipped so the high frequencies are at the top
+        for(UINT i=0; i<FFT_MAG_SIZE; i++){
+            spectrogramColumn[i] = scaledMagData[FFT_MAG_SIZE-1-i];
+        }
+        spectrogramColumns.push( &spectrogramColumn[0], false, "", ofGetElapsedTimeMillis() );
 
         UINT featureIndex = 0;
         for(UINT i=0; i<SPECTROGRAM_SIZE; i++){
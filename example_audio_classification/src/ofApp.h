@@ -37,7 +37,9 @@ public:
     VectorFloat featureVector;
     FastFourierTransform fft;
     CircularBuffer< VectorFloat > spectrogram;
-    CircularBuffer< VectorFloat > spectrogramPlotBuffer;
+    ofxGrtIngestQueue spectrogramColumns; //Passes the spectrogram columns from the audio thread to update
+    ofxGrtIngestQueue::Frame spectrogramFrame;
+    vector< float > spectrogramColumn;
     ofxGrtTimeseriesPlot magnitudePlot;
     ofxGrtTimeseriesPlot classLikelihoodsPlot;
     ofxGrtMatrixPlot spectrogramPlot;
@@ -177,8 +177,20 @@ void ofApp::keyPressed(int key){
         const unsigned int rows = TEXTURE_RESOLUTION;
         const unsigned int cols = TEXTURE_RESOLUTION;
         const unsigned int size = rows*cols*4;
-        vector<float> pixelData( size );
-        ofFloatPixels pixels;
+
+        //The decision surface is large, so it is written straight into a mapped pixel buffer and uploaded from there, which avoids copying
+        //it and stalling the frame while the driver transfers it. The texture is allocated first, as the buffer is uploaded into it
+        if(!texture.isAllocated()){
+            texture.allocate( rows, cols, GL_RGBA32F, false );
+            texture.setRGToRGBASwizzles(true);
+        }
+        vector<float> fallbackData;
+        float *pixelData = static_cast< float* >( uploader.map( size*sizeof(float) ) );
+        if( pixelData == NULL ){
+            //The pixel buffer could not be mapped (e.g. on OpenGL ES), so build the pixels in memory and upload them directly
+            fallbackData.resize( size );
+            pixelData = &fallbackData[0];
+        }
 
         unsigned int index = 0;
         unsigned int classLabel = 0;
@@ -191,6 +203,8 @@ void ofApp::keyPressed(int key){
             for(unsigned int i=0; i<rows; i++){
                 featureVector[0] = i/double(rows);
                 featureVector[1] = j/double(cols);
+                //The mapped buffer is not cleared, so a point that can not be predicted is written as a transparent pixel
+                r = g = b = a = 0;
                 if( pipeline.predict( featureVector ) ){
                     classLabel = pipeline.getPredictedClassLabel();
                     maximumLikelihood = pipeline.getMaximumLikelihood();
@@ -242,20 +256,16 @@ void ofApp::keyPressed(int key){
                             break;
                         }
                     }
-                    
-                    pixelData[ index++ ] = r;
-                    pixelData[ index++ ] = g;
-                    pixelData[ index++ ] = b;
-                    pixelData[ index++ ] = a;
                 }
+
+                pixelData[ index++ ] = r;
+                pixelData[ index++ ] = g;
+                pixelData[ index++ ] = b;
+                pixelData[ index++ ] = a;
             }
         }
-        pixels.setFromExternalPixels(&pixelData[0],rows,cols,OF_PIXELS_RGBA);
-        if(!texture.isAllocated()){
-            texture.allocate( pixels, false );
-            texture.setRGToRGBASwizzles(true);
-        }
-        texture.loadData( pixels );
+        if( fallbackData.empty() ) uploader.commit( texture, rows, cols, GL_RGBA, GL_FLOAT, 4*sizeof(float) );
+        else texture.loadData( pixelData, rows, cols, GL_RGBA );
         texture.setTextureMinMagFilter( GL_LINEAR, GL_LINEAR );
     }
 
@@ -40,6 +40,7 @@ public:
     string infoText;                            //This string will be used to draw some info messages to the main app window
     Vector< ofColor > classColors;
     ofTexture texture;
+    ofxGrtPixelUploader uploader;
     int classifierType;
     ofTrueTypeFont largeFont;
     ofTrueTypeFont smallFont;
@@ -398,7 +398,7 @@ void ofApp::drawDistanceMatrix(){
 
     y += 15;
     for(UINT i=0; i<distanceMatrix.getSize(); i++){
-        distanceMatrixPlots[i].update( distanceMatrix[i], distanceMatrix[i].getMinValue(), distanceMatrix[i].getMaxValue() );
+        distanceMatrixPlots[i].updateNormalized( distanceMatrix[i] );
         shader.begin();
         distanceMatrixPlots[i].draw( x, y, w, h );
         shader.end();
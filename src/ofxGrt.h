@@ -24,4 +24,7 @@
 #include "ofxGrtMatrixPlot.h"
 #include "ofxGrtTimeseriesPlot.h"
 #include "ofxGrtBarPlot.h"
+#include "ofxGrtPlotGroup.h"
+#include "ofxGrtPixelUploader.h"
+#include "ofxGrtMatrixTiles.h"
 
@@ -1,10 +1,75 @@
 #include "ofxGrtBarPlot.h"
+
+//The attribute location used to stream the value and range of each bar to the instanced shader
+static const int BAR_ATTRIBUTE = 4;
+
+//The corners of the unit quad every bar is drawn from, in triangle strip order
+static const float barQuad[8] = { 0,0, 1,0, 0,1, 1,1 };
+
+//Each bar is one instance of the unit quad, the corner comes from the position and the bar from gl_InstanceID, so the only per-bar data is [value min max]
+static const std::string barVertexShader = R"(
+#version 150
+uniform mat4 modelViewProjectionMatrix;
+uniform float xStart;
+uniform float barStep;
+uniform float barWidth;
+uniform float plotHeight;
+uniform int constrainValues;
+in vec4 position;
+in vec3 bar;
+void main(){
+    float barHeight = 0.0;
+    if( bar.y != bar.z ){
+        barHeight = 1.0 + (bar.x - bar.y) / (bar.z - bar.y) * (plotHeight - 2.0);
+        if( constrainValues != 0 ) barHeight = clamp( barHeight, 1.0, plotHeight - 1.0 );
+    }
+    float x = xStart + float(gl_InstanceID) * barStep + position.x * barWidth;
+    float y = plotHeight - 1.0 - position.y * barHeight;
+    gl_Position = modelViewProjectionMatrix * vec4( x, y, 0.0, 1.0 );
+}
+)";
+
+static const std::string barFragmentShader = R"(
+#version 150
+uniform vec4 barColor;
+out vec4 outputColor;
+void main(){
+    outputColor = barColor;
+}
+)";
+
+//All bar plots share one shader, it is compiled the first time a plot is drawn with the programmable renderer. Returns NULL if the shader
+//could not be built or the context has no instanced attributes (GL 3.3 or ARB_instanced_arrays), in which case the bars are drawn one by one
+static ofShader* getBarShader(){
+    static ofShader shader;
+    static bool initialized = false;
+    static bool supported = false;
+    if( !initialized ){
+        initialized = true;
+        GLint major = 0;
+        GLint minor = 0;
+        glGetIntegerv( GL_MAJOR_VERSION, &major );
+        glGetIntegerv( GL_MINOR_VERSION, &minor );
+        if( major > 3 || (major == 3 && minor >= 3) || ofGLCheckExtension( "GL_ARB_instanced_arrays" ) ){
+            if( shader.setupShaderFromSource( GL_VERTEX_SHADER, barVertexShader ) && shader.setupShaderFromSource( GL_FRAGMENT_SHADER, barFragmentShader ) ){
+                shader.bindDefaults();
+                shader.bindAttribute( BAR_ATTRIBUTE, "bar" );
+                supported = shader.linkProgram();
+            }
+        }
+    }
+    return supported ? &shader : NULL;
+}
     
 ofxGrtBarPlot::ofxGrtBarPlot(){
+    vboBars = 0;
+    linkRanges = false;
+    dynamicScale = false;
+    peakDecay = 1.0f - std::pow( 0.5f, 1.0f / 100.0f );
+    minDynamicRange = 0.05f;
     numDimensions = 0;
     drawGrid = false;
     initialized = false;
-    rangesComputed = false;
     lockRanges = false;
     drawInfoText = true;
     constrainValuesToGraph = true;
@@ -32,11 +97,14 @@ bool ofxGrtBarPlot::setup(unsigned int numDimensions,const std::string title){
     this->numDimensions = numDimensions;
     this->title = title;
     lockRanges = false;
-    rangesComputed = false;
     constrainValuesToGraph = true;
     data.resize(numDimensions,0);
-    minRanges.resize(numDimensions,0);
-    maxRanges.resize(numDimensions,0);
+    barRanges.setup( numDimensions );
+    if( updateGate.getIsOpen() ){
+        updateGate.close();
+        setupSnapshot();
+        updateGate.open();
+    }
     return true;
 }
 
@@ -45,7 +113,7 @@ bool ofxGrtBarPlot::resetAxisRanges(){
     std::unique_lock<std::mutex> lock( mtx );
 
     if( !lockRanges ){
-        rangesComputed = false;
+        barRanges.restart();
         return true;
     }
     return false;
@@ -56,10 +124,12 @@ bool ofxGrtBarPlot::setRanges( const float minY, const float maxY, const bool lo
     std::unique_lock<std::mutex> lock( mtx );
 
     for(unsigned int i=0; i<numDimensions; i++){
-        minRanges[i] = minY;
-        maxRanges[i] = maxY;
+        barRanges.setRange( i, minY, maxY );
     }
+    barRanges.restart();
     this->lockRanges = lockRanges;
+    this->linkRanges = linkRanges;
+    this->dynamicScale = dynamicScale;
     return true;
 }
 
@@ -68,9 +138,9 @@ bool ofxGrtBarPlot::setRanges( const vector< GRT::MinMax > &ranges, const bool l
     std::unique_lock<std::mutex> lock( mtx );
 
     for(unsigned int i=0; i<numDimensions; i++){
-        minRanges[i] = ranges[i].minValue;
-        maxRanges[i] = ranges[i].maxValue;
+        barRanges.setRange( i, ranges[i].minValue, ranges[i].maxValue );
     }
+    barRanges.restart();
     this->lockRanges = lockRanges;
     this->linkRanges = linkRanges;
     this->dynamicScale = dynamicScale;
@@ -79,6 +149,13 @@ bool ofxGrtBarPlot::setRanges( const vector< GRT::MinMax > &ranges, const bool l
 
 bool ofxGrtBarPlot::update( const vector< double > &data ){
 
+    //In lock-free mode the frame is written into the snapshot buffer and published without taking the mutex, draw applies the latest frame
+    if( updateGate.enter() ){
+        const bool result = publishFrame( data.data(), (unsigned int)data.size() );
+        updateGate.leave();
+        return result;
+    }
+
     std::unique_lock<std::mutex> lock( mtx );
     
     if( !initialized ){
@@ -86,25 +163,20 @@ bool ofxGrtBarPlot::update( const vector< double > &data ){
         return false;
     }
 
-    for(unsigned int n=0; n<numDimensions; n++){
-
-        this->data[n] = data[n];
-
-        if( !lockRanges ){
-            if( this->data[n] < minRanges[n] ){ minRanges[n] = this->data[n]; }
-            else if( this->data[n] > maxRanges[n] && this->data[n] != maxRanges[n] ){ maxRanges[n] = this->data[n]; }
-        }
-        
-    }
-    
-    //Flag that the ranges have been computed
-    rangesComputed = true;
+    applyData( &data[0] );
        
     return true;   
 }
 
 bool ofxGrtBarPlot::update( const vector< float > &data ){
 
+    //In lock-free mode the frame is written into the snapshot buffer and published without taking the mutex, draw applies the latest frame
+    if( updateGate.enter() ){
+        const bool result = publishFrame( data.data(), (unsigned int)data.size() );
+        updateGate.leave();
+        return result;
+    }
+
     std::unique_lock<std::mutex> lock( mtx );
     
     if( !initialized ){
@@ -112,23 +184,86 @@ bool ofxGrtBarPlot::update( const vector< float > &data ){
         return false;
     }
 
+    applyData( &data[0] );
+       
+    return true;   
+}
+
+
+template< class T > bool ofxGrtBarPlot::publishFrame( const T *data, const unsigned int size ){
+
+    if( size != barRanges.getProducerNumBars() ) return false;
+
+    //Every update is tracked here rather than only the frame draw happens to take, so extremes between draws are kept and the peaks decay once per update
+    barRanges.track( data, snapshot.getWriteFrame(), peakDecay.load( std::memory_order_relaxed ) );
+    snapshot.publish();
+
+    return true;
+}
+
+void ofxGrtBarPlot::applySnapshotFrame( const float *frame ){
+
     for(unsigned int n=0; n<numDimensions; n++){
+        this->data[n] = frame[ ofxGrtBarRanges::FRAME_VALUE*numDimensions + n ];
+    }
+    barRanges.merge( frame, !lockRanges );
+}
 
-        this->data[n] = data[n];
+void ofxGrtBarPlot::setupSnapshot(){
 
-        if( !lockRanges ){
-            if( this->data[n] < minRanges[n] ){ minRanges[n] = this->data[n]; }
-            else if( this->data[n] > maxRanges[n] && this->data[n] != maxRanges[n] ){ maxRanges[n] = this->data[n]; }
-        }
-        
+    snapshot.setup( barRanges.getFrameSize() );
+    barRanges.setupProducer();
+}
+
+template< class T > void ofxGrtBarPlot::applyData( const T *data ){
+
+    for(unsigned int n=0; n<numDimensions; n++){
+        this->data[n] = data[n];
     }
-    
-    //Flag that the ranges have been computed
-    rangesComputed = true;
-       
-    return true;   
+
+    //The peaks are always tracked so dynamic scaling can be switched on at any time
+    barRanges.update( data, !lockRanges, peakDecay.load( std::memory_order_relaxed ) );
+}
+
+bool ofxGrtBarPlot::setDynamicScaleWindow( const unsigned int numUpdates ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( numUpdates == 0 ) return false;
+
+    //The decay halves the distance between a peak and the signal every numUpdates updates
+    peakDecay = 1.0f - std::pow( 0.5f, 1.0f / numUpdates );
+    return true;
 }
 
+bool ofxGrtBarPlot::setDynamicScaleMinRange( const float fraction ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( fraction < 0 || fraction > 1 ) return false;
+
+    minDynamicRange = fraction;
+    return true;
+}
+
+bool ofxGrtBarPlot::setLockFreeUpdates( const bool enabled ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    //Disable the lock-free path and wait for any update in progress to finish before the snapshot is reallocated
+    updateGate.close();
+    if( !enabled ) return true;
+
+    if( !initialized ){
+        warningLog << "setLockFreeUpdates( const bool enabled ) the plot must be setup before lock-free updates can be enabled!" << endl;
+        return false;
+    }
+
+    setupSnapshot();
+    updateGate.open();
+
+    return true;
+}
 
 bool ofxGrtBarPlot::draw(unsigned int x,unsigned int y,unsigned int w,unsigned int h){
 
@@ -136,15 +271,103 @@ bool ofxGrtBarPlot::draw(unsigned int x,unsigned int y,unsigned int w,unsigned i
     
     if( !initialized ) return false;
 
+    //Take the latest frame published by the producer, the frame is never read while it is being written
+    if( updateGate.getIsOpen() && snapshot.acquire() ){
+        applySnapshotFrame( snapshot.getReadFrame() );
+    }
+
+    ofPushMatrix();
+    ofEnableAlphaBlending();
+    ofTranslate(x, y);
+    
+    //The background, grid and axes only change with the size or style of the plot, so they are drawn from a cached layer
+    if( !chromeLayer.isValid( w, h ) ){
+        chromeLayer.begin( w, h, 5 );
+        drawChrome( w, h );
+        chromeLayer.end();
+    }
+    chromeLayer.draw();
+    
+    barRanges.computeDrawRanges( lockRanges, linkRanges, dynamicScale, minDynamicRange );
+
+    float barWidth = floor(w/(numDimensions+1.0));
+    float barSpacer = (w-(barWidth*numDimensions))/numDimensions;
+    
+    //With the programmable renderer all the bars are drawn as instances of one quad in a single draw call
+    if( ofIsGLProgrammableRenderer() && drawInstancedBars( barWidth, barSpacer, h ) ){
+        ofDisableAlphaBlending();
+        ofPopMatrix();
+        return true;
+    }
+
+    //Draw the bars
+    ofSetColor(barColor[0],barColor[1],barColor[2]);
+    ofFill();
+    float x1 = barSpacer/2.0;
+    float x2 = 0;
+    float y1 = 0;
+    float y2 = 0;
+    float barHeight = 0;
+    for(unsigned int n=0; n<numDimensions; n++){
+        if( barRanges.getDrawMinRange(n) != barRanges.getDrawMaxRange(n) ){
+            barHeight = ofMap(data[n],barRanges.getDrawMinRange(n),barRanges.getDrawMaxRange(n),1,h-1,constrainValuesToGraph);
+            x2 = barWidth;
+            y1 = 0 + h-barHeight-1;
+            y2 = barHeight; 
+            ofDrawRectangle(x1,y1,x2,y2);
+        }
+        
+        x1 += barWidth + barSpacer;
+    }
+    
+    ofDisableAlphaBlending();
+    ofPopMatrix();
+    
+    return true;
+}
+
+bool ofxGrtBarPlot::drawInstancedBars( const float barWidth, const float barSpacer, const float h ){
+
+    ofShader *shader = getBarShader();
+    if( shader == NULL || numDimensions == 0 ) return false;
+
+    //The value and range of each bar are interleaved, so the whole plot is a single upload of 3 floats per bar
+    barData.resize( numDimensions*3 );
+    for(unsigned int n=0; n<numDimensions; n++){
+        barData[n*3] = data[n];
+        barData[n*3+1] = barRanges.getDrawMinRange(n);
+        barData[n*3+2] = barRanges.getDrawMaxRange(n);
+    }
+    if( vboBars != numDimensions ){
+        //ofVbo only draws when it has vertex data, the quad corners are the vertices and every bar is an instance of them
+        barVbo.setVertexData( barQuad, 2, 4, GL_STATIC_DRAW, 2*sizeof(float) );
+        barVbo.setAttributeData( BAR_ATTRIBUTE, &barData[0], 3, numDimensions, GL_DYNAMIC_DRAW, 3*sizeof(float) );
+        barVbo.setAttributeDivisor( BAR_ATTRIBUTE, 1 );
+        vboBars = numDimensions;
+    }else{
+        barVbo.updateAttributeData( BAR_ATTRIBUTE, &barData[0], numDimensions );
+    }
+
+    shader->begin();
+    shader->setUniform1f( "xStart", barSpacer/2.0 );
+    shader->setUniform1f( "barStep", barWidth + barSpacer );
+    shader->setUniform1f( "barWidth", barWidth );
+    shader->setUniform1f( "plotHeight", h );
+    shader->setUniform1i( "constrainValues", constrainValuesToGraph ? 1 : 0 );
+    shader->setUniform4f( "barColor", barColor.r/255.0f, barColor.g/255.0f, barColor.b/255.0f, barColor.a/255.0f );
+    barVbo.drawInstanced( GL_TRIANGLE_STRIP, 0, 4, numDimensions );
+    shader->end();
+
+    return true;
+}
+
+void ofxGrtBarPlot::drawChrome( const float w, const float h ){
+    
     float xStart = 0;
     float xEnd = 0;
     float yStart = 0;
     float yEnd = 0;
     
-    ofPushMatrix();
-    ofEnableAlphaBlending();
-    ofTranslate(x, y);
-    
     //Draw the background
     ofFill();
     ofSetColor(backgroundColor[0],backgroundColor[1],backgroundColor[2]);
@@ -175,36 +398,8 @@ bool ofxGrtBarPlot::draw(unsigned int x,unsigned int y,unsigned int w,unsigned i
         }
     }
     
-    float barWidth = floor(w/(numDimensions+1.0));
-    float barSpacer = (w-(barWidth*numDimensions))/numDimensions;
-    
     //Draw the axis lines
     ofSetColor(255,255,255);
     ofDrawLine(-5,h,w+5,h); //X Axis
     ofDrawLine(0,-5,0,h+5); //Y Axis
-    
-    //Draw the bars
-    ofSetColor(barColor[0],barColor[1],barColor[2]);
-    ofFill();
-    float x1 = barSpacer/2.0;
-    float x2 = 0;
-    float y1 = 0;
-    float y2 = 0;
-    float barHeight = 0;
-    for(unsigned int n=0; n<numDimensions; n++){
-        if( minRanges[n] != maxRanges[n] ){
-            barHeight = ofMap(data[n],minRanges[n],maxRanges[n],1,h-1,constrainValuesToGraph);
-            x2 = barWidth;
-            y1 = 0 + h-barHeight-1;
-            y2 = barHeight; 
-            ofDrawRectangle(x1,y1,x2,y2);
-        }
-        
-        x1 += barWidth + barSpacer;
-    }
-    
-    ofDisableAlphaBlending();
-    ofPopMatrix();
-    
-    return true;
 }
@@ -1,6 +1,10 @@
 #pragma once
 #include "ofMain.h"
 #include "GRT/GRT.h"
+#include "ofxGrtCachedLayer.h"
+#include "ofxGrtSnapshotBuffer.h"
+#include "ofxGrtProducerGate.h"
+#include "ofxGrtBarRanges.h"
 
 using namespace GRT;
 
@@ -34,6 +38,34 @@ public:
     */
     bool update( const vector<double> &data );
 
+    /**
+     @brief enables a lock-free update path so the plot can be fed from a real-time thread (e.g. an audio callback) without the risk of blocking on the draw thread.
+     Once enabled, update writes the whole frame into a triple buffer and publishes it with a single atomic exchange instead of taking the plot mutex, and draw
+     applies the latest published frame. The producer never waits and draw never sees a partially written frame, frames published between two draws are replaced
+     by the latest one. The producer still tracks the extremes and decaying peaks of every update, so the ranges include values that were never drawn and the
+     peaks decay per update as they do with the locked path. Only one thread may call update at a time. This should be called after setup, it can be called while the producer is running,
+     as can setup, both wait for any update in progress to finish before the buffer is reallocated.
+     @param enabled: if true, then update will publish frames without locking
+     @return returns true if the parameter was updated successfully, false otherwise
+    */
+    bool setLockFreeUpdates( const bool enabled );
+
+    /**
+     @brief sets how quickly the dynamic range follows the signal when dynamicScale is enabled. Each bar tracks a decaying max and min peak, a peak jumps to any
+     new extreme and then decays back towards the signal, halving the gap every numUpdates updates. The default is 100 updates
+     @param numUpdates: the number of updates it takes a peak to decay halfway back to the signal
+     @return returns true if the parameter was update successfully, false otherwise
+    */
+    bool setDynamicScaleWindow( const unsigned int numUpdates );
+
+    /**
+     @brief sets the smallest range the dynamic scale can shrink to, as a fraction of the locked or grown range of each bar (or of all the bars if the ranges are linked).
+     Without a floor the peaks of a steady signal decay onto the signal and any noise on it would fill the whole plot. The default is 0.05
+     @param fraction: the minimum dynamic range as a fraction of the full range, this must be in the range [0 1]
+     @return returns true if the parameter was update successfully, false otherwise
+    */
+    bool setDynamicScaleMinRange( const float fraction );
+
     /**
      @brief draws the plot.     
      @return returns true if the plot was drawn successfully, false otherwise
@@ -48,7 +80,7 @@ public:
      @param maxY: the maximum range for the Y axis
      @param lockRanges: if true, then the ranges of the plot will be fixed to minY/maxY, if false then the min/max ranges of the plot will be updated based on the min/max values observed in the data
      @param linkRanges: if true, then the channels of the plot will all be scaled using a global min/max value (updated across all ranges). If false, then each channel will have it's own min/max value and be updated independently from the other channels
-     @param dynamicScale: if true, then the contents of the plot will be scaled by on the current min/max values found in the timeseries buffer
+     @param dynamicScale: if true, then the contents of the plot will be scaled by the decaying min/max peaks of each bar, so the plot follows the recent signal level (see setDynamicScaleWindow)
      @return returns true if the parameters were update successfully, false otherwise
     */
     bool setRanges( const float minY, const float maxY, const bool lockRanges = false, const bool linkRanges = false, const bool dynamicScale = false );
@@ -58,7 +90,7 @@ public:
      @param ranges: a vector containing the min/max values for each channel
      @param lockRanges: if true, then the ranges of the plot will be fixed to minY/maxY, if false then the min/max ranges of the plot will be updated based on the min/max values observed in the data
      @param linkRanges: if true, then the channels of the plot will all be scaled using a global min/max value (updated across all ranges). If false, then each channel will have it's own min/max value and be updated independently from the other channels
-     @param dynamicScale: if true, then the contents of the plot will be scaled by on the current min/max values found in the timeseries buffer
+     @param dynamicScale: if true, then the contents of the plot will be scaled by the decaying min/max peaks of each bar, so the plot follows the recent signal level (see setDynamicScaleWindow)
      @return returns true if the parameters were update successfully, false otherwise
     */
     bool setRanges( const vector< GRT::MinMax > &ranges, const bool lockRanges = false, const bool linkRanges = false, const bool dynamicScale = false );
@@ -82,6 +114,7 @@ public:
     bool setDrawGrid( const bool drawGrid ){ 
         std::unique_lock<std::mutex> lock( mtx );
         this->drawGrid = drawGrid; 
+        chromeLayer.invalidate();
         return true; 
     }
 
@@ -108,8 +141,8 @@ public:
     }
 
     /**
-     @brief controls if the Y axis plot ranges should be dynamically scaled based on the current contents of the timeseries buffer
-     @param dynamicScale: if true, then the plot ranges will all be dynamicall scaled using the current min/max values of the contents of the timeseries buffer
+     @brief controls if the Y axis plot ranges should be dynamically scaled based on the recent values of each bar (see setDynamicScaleWindow), rather than growing to the largest range ever seen
+     @param dynamicScale: if true, then the plot ranges will all be dynamically scaled using the decaying min/max peaks of each bar
      @return returns true if the parameter was update successfully, false otherwise
     */
     bool setDynamicScale( const bool dynamicScale ){ 
@@ -120,13 +153,45 @@ public:
 
 
 protected:
+    /**
+     @brief draws the background, grid and axes, this is cached in the chromeLayer
+    */
+    void drawChrome( const float w, const float h );
+
+    /**
+     @brief copies a frame into the plot and updates the ranges, the caller must hold the mutex
+    */
+    template< class T > void applyData( const T *data );
+
+    /**
+     @brief copies a frame into the snapshot buffer and publishes it, this is only called by the producer while it is inside the updateGate
+     @return returns true if the frame was published, false if its size does not match the number of dimensions
+    */
+    template< class T > bool publishFrame( const T *data, const unsigned int size );
+
+    /**
+     @brief copies a frame taken from the snapshot into the plot, merging the producer's extremes into the ranges and taking its peaks. The caller must hold the mutex
+    */
+    void applySnapshotFrame( const float *frame );
+
+    /**
+     @brief allocates the snapshot and the producer's peak state for the current number of dimensions, the caller must hold the mutex with the updateGate closed
+    */
+    void setupSnapshot();
+
+    /**
+     @brief draws all the bars as instances of one quad with a single draw call, the range mapping is done in the vertex shader
+     @return returns true if the bars were drawn, false if instancing is not available and the bars must be drawn one by one
+    */
+    bool drawInstancedBars( const float barWidth, const float barSpacer, const float h );
+
     mutable std::mutex mtx;
     UINT numDimensions;
-    vector< float > minRanges;
-    vector< float > maxRanges;
+    ofxGrtBarRanges barRanges; ///< The locked or grown ranges, the decaying peaks and the draw ranges of the bars, also tracks the lock-free producer
+    std::atomic< float > peakDecay; ///< The fraction of the gap between a peak and the signal that is closed each update, also read by the lock-free producer
+    float minDynamicRange; ///< The smallest dynamic range, as a fraction of the locked or grown range
     vector< float > data;
     bool initialized;
-    bool rangesComputed;
     bool lockRanges;
     bool linkRanges;
     bool dynamicScale;
@@ -138,6 +203,12 @@ protected:
     ofColor gridColor;
     ofColor barColor;
     string title;
+    ofxGrtCachedLayer chromeLayer; ///< The cached background, grid and axes
+    ofVbo barVbo; ///< The [value min max] of each bar, one instance per bar
+    vector< float > barData;
+    unsigned int vboBars; ///< The number of bars the vbo was allocated for
+    ofxGrtProducerGate updateGate; ///< Open while update publishes into the snapshot rather than taking the mutex, closed before the snapshot is reallocated
+    ofxGrtSnapshotBuffer snapshot;
     
     WarningLog warningLog;
     const ofTrueTypeFont *font;
@@ -0,0 +1,214 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+/**
+ @brief The ranges of the bars of an ofxGrtBarPlot: the min/max range of each bar (locked or grown from the data), the decaying min/max peaks used for
+ dynamic scaling and the ranges each bar is drawn with. The peaks jump out to any new extreme and then decay back towards the signal, so the dynamic range
+ follows the recent signal level without keeping any history.
+ With the locked path every frame is applied with update. With the lock-free path the producer calls track for every frame, which keeps its own extremes
+ and peaks and writes them with the values into a snapshot frame, and the consumer applies the latest frame with merge, so the extremes of the frames it
+ never sees are not lost and the peaks decay once per update on both paths. This class does no locking, the consumer methods must be serialized by the
+ caller and track must only be called by one producer at a time.
+*/
+class ofxGrtBarRanges{
+public:
+    enum{ FRAME_VALUE=0, FRAME_MIN, FRAME_MAX, FRAME_MIN_PEAK, FRAME_MAX_PEAK, FRAME_NUM_FIELDS }; ///< The blocks of a snapshot frame, each holds one value per bar
+
+    ofxGrtBarRanges(){
+        numBars = 0;
+        peaksStarted = false;
+        restarts = 0;
+        producerRestarts = 0;
+        producerStarted = false;
+    }
+
+    /**
+     @brief sets the number of bars, new bars start with a [0 0] range. The peaks restart from the next frame
+    */
+    void setup( const unsigned int numBars ){
+        this->numBars = numBars;
+        minRanges.resize( numBars, 0 );
+        maxRanges.resize( numBars, 0 );
+        minPeaks.resize( numBars, 0 );
+        maxPeaks.resize( numBars, 0 );
+        drawMinRanges.resize( numBars, 0 );
+        drawMaxRanges.resize( numBars, 0 );
+        peaksStarted = false;
+    }
+
+    /**
+     @brief allocates the producer state for the current number of bars, this must not be called while the producer is inside track
+    */
+    void setupProducer(){
+        producerMinValues.assign( numBars, 0 );
+        producerMaxValues.assign( numBars, 0 );
+        producerMinPeaks.assign( numBars, 0 );
+        producerMaxPeaks.assign( numBars, 0 );
+        producerStarted = false;
+    }
+
+    void setRange( const unsigned int bar, const float minValue, const float maxValue ){
+        minRanges[ bar ] = minValue;
+        maxRanges[ bar ] = maxValue;
+    }
+
+    /**
+     @brief restarts the peaks from the next frame, and tells the producer to restart its extremes and peaks from the next frame it tracks
+    */
+    void restart(){
+        peaksStarted = false;
+        restarts.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    /**
+     @brief applies a frame of the locked path
+     @param growRanges: if true, then the ranges grow to include the values
+     @param peakDecay: the fraction of the gap between a peak and the signal that is closed each update
+    */
+    template< class T > void update( const T *values, const bool growRanges, const float peakDecay ){
+        for(unsigned int n=0; n<numBars; n++){
+            const float value = (float)values[n];
+            if( growRanges ){
+                if( value < minRanges[n] ) minRanges[n] = value;
+                else if( value > maxRanges[n] ) maxRanges[n] = value;
+            }
+            if( !peaksStarted ) minPeaks[n] = maxPeaks[n] = value;
+            else updatePeaks( value, minPeaks[n], maxPeaks[n], peakDecay );
+        }
+        peaksStarted = true;
+    }
+
+    /**
+     @brief tracks a frame on the producer side and writes the snapshot frame (getFrameSize values) the consumer applies with merge
+    */
+    template< class T > void track( const T *values, float *frame, const float peakDecay ){
+        //The extremes and peaks restart from this frame after setupProducer or when the consumer has called restart
+        const unsigned int numRestarts = restarts.load( std::memory_order_relaxed );
+        const bool restartProducer = !producerStarted || numRestarts != producerRestarts;
+        producerStarted = true;
+        producerRestarts = numRestarts;
+
+        const unsigned int size = (unsigned int)producerMinPeaks.size();
+        for(unsigned int n=0; n<size; n++){
+            const float value = (float)values[n];
+            if( restartProducer ){
+                producerMinValues[n] = producerMaxValues[n] = value;
+                producerMinPeaks[n] = producerMaxPeaks[n] = value;
+            }else{
+                if( value < producerMinValues[n] ) producerMinValues[n] = value;
+                if( value > producerMaxValues[n] ) producerMaxValues[n] = value;
+                updatePeaks( value, producerMinPeaks[n], producerMaxPeaks[n], peakDecay );
+            }
+            frame[ FRAME_VALUE*size + n ] = value;
+            frame[ FRAME_MIN*size + n ] = producerMinValues[n];
+            frame[ FRAME_MAX*size + n ] = producerMaxValues[n];
+            frame[ FRAME_MIN_PEAK*size + n ] = producerMinPeaks[n];
+            frame[ FRAME_MAX_PEAK*size + n ] = producerMaxPeaks[n];
+        }
+    }
+
+    /**
+     @brief applies a snapshot frame written by track, the producer's extremes cover every frame since the last restart so the ranges grow exactly as if
+     each frame had been applied, and the peaks are taken as they are
+    */
+    void merge( const float *frame, const bool growRanges ){
+        for(unsigned int n=0; n<numBars; n++){
+            if( growRanges ){
+                minRanges[n] = std::min( minRanges[n], frame[ FRAME_MIN*numBars + n ] );
+                maxRanges[n] = std::max( maxRanges[n], frame[ FRAME_MAX*numBars + n ] );
+            }
+            minPeaks[n] = frame[ FRAME_MIN_PEAK*numBars + n ];
+            maxPeaks[n] = frame[ FRAME_MAX_PEAK*numBars + n ];
+        }
+        peaksStarted = true;
+    }
+
+    /**
+     @brief sets the range each bar is drawn with. Locked ranges are always used as they are, otherwise dynamic scaling uses the peaks rather than the ranges
+     that only ever grow. The peaks of a steady signal decay onto the signal, which would blow its noise up to the full height of the plot, so the dynamic range
+     is never narrower than minDynamicRange of the grown range (or of the linked range), it is widened around the centre of the peaks. If the grown range is
+     empty the draw range is empty too, as it is without dynamic scaling
+    */
+    void computeDrawRanges( const bool lockRanges, const bool linkRanges, const bool dynamicScale, const float minDynamicRange ){
+        const bool useDynamicRange = dynamicScale && !lockRanges;
+        const std::vector< float > &minSource = useDynamicRange ? minPeaks : minRanges;
+        const std::vector< float > &maxSource = useDynamicRange ? maxPeaks : maxRanges;
+        std::copy( minSource.begin(), minSource.end(), drawMinRanges.begin() );
+        std::copy( maxSource.begin(), maxSource.end(), drawMaxRanges.begin() );
+
+        if( linkRanges && numBars > 0 ){
+            const float minValue = *std::min_element( drawMinRanges.begin(), drawMinRanges.end() );
+            const float maxValue = *std::max_element( drawMaxRanges.begin(), drawMaxRanges.end() );
+            std::fill( drawMinRanges.begin(), drawMinRanges.end(), minValue );
+            std::fill( drawMaxRanges.begin(), drawMaxRanges.end(), maxValue );
+        }
+
+        if( useDynamicRange && numBars > 0 ){
+            const float linkedRange = *std::max_element( maxRanges.begin(), maxRanges.end() ) - *std::min_element( minRanges.begin(), minRanges.end() );
+            for(unsigned int n=0; n<numBars; n++){
+                const float minRange = minDynamicRange * ( linkRanges ? linkedRange : maxRanges[n] - minRanges[n] );
+                if( drawMaxRanges[n] - drawMinRanges[n] < minRange ){
+                    const float centre = (drawMinRanges[n] + drawMaxRanges[n]) * 0.5f;
+                    drawMinRanges[n] = centre - minRange * 0.5f;
+                    drawMaxRanges[n] = centre + minRange * 0.5f;
+                }
+            }
+        }
+    }
+
+    unsigned int getNumBars() const { return numBars; }
+    unsigned int getFrameSize() const { return numBars*FRAME_NUM_FIELDS; }
+    unsigned int getProducerNumBars() const { return (unsigned int)producerMinPeaks.size(); } ///< The number of bars track expects, only call this from the producer
+    float getMinRange( const unsigned int bar ) const { return minRanges[ bar ]; }
+    float getMaxRange( const unsigned int bar ) const { return maxRanges[ bar ]; }
+    float getMinPeak( const unsigned int bar ) const { return minPeaks[ bar ]; }
+    float getMaxPeak( const unsigned int bar ) const { return maxPeaks[ bar ]; }
+    float getDrawMinRange( const unsigned int bar ) const { return drawMinRanges[ bar ]; }
+    float getDrawMaxRange( const unsigned int bar ) const { return drawMaxRanges[ bar ]; }
+
+protected:
+    static void updatePeaks( const float value, float &minPeak, float &maxPeak, const float decay ){
+        if( value >= maxPeak ) maxPeak = value;
+        else maxPeak += (value - maxPeak) * decay;
+        if( value <= minPeak ) minPeak = value;
+        else minPeak += (value - minPeak) * decay;
+    }
+
+    unsigned int numBars;
+    std::vector< float > minRanges; ///< The locked or grown range of each bar
+    std::vector< float > maxRanges;
+    std::vector< float > minPeaks; ///< The decaying min of each bar, used when dynamic scaling is enabled
+    std::vector< float > maxPeaks; ///< The decaying max of each bar, used when dynamic scaling is enabled
+    std::vector< float > drawMinRanges; ///< The min range each bar is drawn with, set by computeDrawRanges
+    std::vector< float > drawMaxRanges;
+    bool peaksStarted; ///< False until a frame has been applied since setup or restart
+    std::atomic< unsigned int > restarts; ///< Incremented by restart, so the producer restarts its extremes and peaks
+    std::vector< float > producerMinValues; ///< The extremes and peaks tracked by the producer, only touched by track and setupProducer
+    std::vector< float > producerMaxValues;
+    std::vector< float > producerMinPeaks;
+    std::vector< float > producerMaxPeaks;
+    unsigned int producerRestarts; ///< The value of restarts the producer last restarted at
+    bool producerStarted; ///< False until the producer has tracked its first frame since setupProducer
+};
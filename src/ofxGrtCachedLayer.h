@@ -0,0 +1,110 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+#include "ofMain.h"
+
+/**
+ @brief Caches content that rarely changes (e.g. a plots background, grid, axes and ticks) in an ofFbo, so it can be drawn with one textured quad per frame.
+ The layer is redrawn when the size it was drawn for changes or after invalidate has been called, which should happen whenever a setting the content depends on changes:
+
+    if( !layer.isValid( w, h ) ){
+        layer.begin( w, h, padding );
+        //draw the content in plot coordinates
+        layer.end();
+    }
+    layer.draw();
+
+ The content is drawn into the fbo with premultiplied alpha and composited with matching blending, so translucent content looks the same as if it was drawn directly.
+*/
+class ofxGrtCachedLayer{
+public:
+    ofxGrtCachedLayer(){
+        valid = false;
+        width = 0;
+        height = 0;
+        padding = 0;
+    }
+
+    /**
+     @brief flags the layer to be redrawn before it is next used
+    */
+    void invalidate(){ valid = false; }
+
+    /**
+     @return returns true if the layer holds content drawn for a plot of this size, false if it needs to be redrawn
+    */
+    bool isValid( const float width, const float height ) const {
+        return valid && width == this->width && height == this->height;
+    }
+
+    /**
+     @brief starts drawing the content of the layer, the current matrix is setup so the content can be drawn in plot coordinates
+     @param padding: the distance the content can extend outside of [0,0,width,height] (e.g. for axis ticks and labels)
+    */
+    void begin( const float width, const float height, const float padding ){
+        this->width = width;
+        this->height = height;
+        this->padding = padding;
+
+        const int fboWidth = (int)ceil( width + padding*2 );
+        const int fboHeight = (int)ceil( height + padding*2 );
+        if( !fbo.isAllocated() || fbo.getWidth() != fboWidth || fbo.getHeight() != fboHeight ){
+            fbo.allocate( fboWidth, fboHeight, GL_RGBA );
+        }
+
+        fbo.begin();
+        ofClear( 0, 0, 0, 0 );
+        ofPushStyle();
+        ofEnableAlphaBlending();
+        //Accumulate the alpha channel rather than blending it, so the fbo holds premultiplied colors
+        glBlendFuncSeparate( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA );
+        ofPushMatrix();
+        ofTranslate( padding, padding );
+    }
+
+    void end(){
+        ofPopMatrix();
+        ofPopStyle();
+        fbo.end();
+        valid = true;
+    }
+
+    /**
+     @brief draws the layer in plot coordinates (i.e. in the same coordinate space the content was drawn in)
+    */
+    void draw() const {
+        if( !valid ) return;
+        ofPushStyle();
+        ofEnableAlphaBlending();
+        glBlendFunc( GL_ONE, GL_ONE_MINUS_SRC_ALPHA );
+        ofSetColor( 255 );
+        fbo.draw( -padding, -padding );
+        ofPopStyle();
+    }
+
+protected:
+    ofFbo fbo;
+    bool valid;
+    float width;
+    float height;
+    float padding;
+};
@@ -0,0 +1,127 @@
+#include "ofxGrtHistoryPyramid.h"
+#include <algorithm>
+
+ofxGrtHistoryPyramid::ofxGrtHistoryPyramid(){
+    numChannels = 0;
+    levelLength = 0;
+    numLevels = 0;
+    reductionFactor = 0;
+    numSamples = 0;
+}
+
+ofxGrtHistoryPyramid::~ofxGrtHistoryPyramid(){
+}
+
+bool ofxGrtHistoryPyramid::setup( const unsigned int numChannels, const unsigned int levelLength, const unsigned int numLevels, const unsigned int reductionFactor ){
+
+    this->numChannels = 0;
+    this->levelLength = 0;
+    this->numLevels = 0;
+    levels.clear();
+    levelScale.clear();
+    accumulators.clear();
+    numSamples = 0;
+
+    if( numChannels == 0 || levelLength == 0 || numLevels == 0 || reductionFactor < 2 ) return false;
+
+    //Stop adding levels once a bucket would cover more samples than can be counted
+    levelScale.push_back( 1 );
+    for(unsigned int k=1; k<numLevels; k++){
+        if( levelScale.back() > ~0ULL / reductionFactor / levelLength ) break;
+        levelScale.push_back( levelScale.back() * reductionFactor );
+    }
+
+    this->numChannels = numChannels;
+    this->levelLength = levelLength;
+    this->numLevels = (unsigned int)levelScale.size();
+    this->reductionFactor = reductionFactor;
+    levels.resize( this->numLevels );
+    for(unsigned int k=0; k<this->numLevels; k++){
+        levels[k].resize( (size_t)numChannels * levelLength );
+    }
+    accumulators.resize( (size_t)numChannels * this->numLevels );
+
+    return true;
+}
+
+void ofxGrtHistoryPyramid::clear(){
+    numSamples = 0;
+}
+
+void ofxGrtHistoryPyramid::write( const unsigned int channel, const float *source, const size_t stride, const size_t numFrames ){
+
+    if( channel >= numChannels ) return;
+
+    const size_t offset = (size_t)channel * levelLength;
+    Accumulator *channelAccumulators = &accumulators[ (size_t)channel * numLevels ];
+
+    for(size_t i=0; i<numFrames; i++){
+        Bucket bucket;
+        bucket.min = bucket.max = bucket.mean = source[ i*stride ];
+
+        //Write the bucket into each level, moving up a level each time it completes a bucket of the level above
+        unsigned long long index = numSamples + i;
+        unsigned int k = 0;
+        while( true ){
+            levels[k][ offset + index % levelLength ] = bucket;
+            if( ++k == numLevels ) break;
+
+            Accumulator &acc = channelAccumulators[k];
+            const unsigned int position = (unsigned int)(index % reductionFactor);
+            if( position == 0 ){
+                acc.min = bucket.min;
+                acc.max = bucket.max;
+                acc.sum = bucket.mean;
+            }else{
+                acc.min = std::min( acc.min, bucket.min );
+                acc.max = std::max( acc.max, bucket.max );
+                acc.sum += bucket.mean;
+            }
+            if( position != reductionFactor-1 ) break;
+
+            bucket.min = acc.min;
+            bucket.max = acc.max;
+            bucket.mean = (float)(acc.sum / reductionFactor);
+            index /= reductionFactor;
+        }
+    }
+}
+
+unsigned long long ofxGrtHistoryPyramid::getOldestSample( const unsigned int level ) const{
+    if( numLevels == 0 ) return 0;
+    const unsigned long long numBuckets = numSamples / levelScale[ level ];
+    return numBuckets > levelLength ? (numBuckets - levelLength) * levelScale[ level ] : 0;
+}
+
+bool ofxGrtHistoryPyramid::getWindow( const unsigned int channel, unsigned long long start, unsigned long long end, const unsigned int maxBuckets, std::vector< Bucket > &buckets, View &view ) const{
+
+    buckets.clear();
+    if( channel >= numChannels || maxBuckets == 0 ) return false;
+
+    end = std::min( end, numSamples );
+    if( start >= end ) return false;
+
+    //Find the finest level that can draw the window in maxBuckets, then move up until the level reaches back to the start of the window
+    unsigned int level = 0;
+    while( level+1 < numLevels && (end - start + getSamplesPerBucket(level) - 1) / getSamplesPerBucket(level) > maxBuckets ) level++;
+    while( level+1 < numLevels && start < getOldestSample(level) ) level++;
+    start = std::max( start, getOldestSample(level) );
+    if( start >= end ) return false;
+
+    const unsigned long long samplesPerBucket = getSamplesPerBucket( level );
+    const unsigned long long firstBucket = start / samplesPerBucket;
+    const unsigned long long lastBucket = std::min( (end + samplesPerBucket - 1) / samplesPerBucket, numSamples / samplesPerBucket );
+    if( firstBucket >= lastBucket ) return false;
+
+    const Bucket *ring = &levels[ level ][ (size_t)channel * levelLength ];
+    buckets.resize( (size_t)(lastBucket - firstBucket) );
+    for(unsigned long long b=firstBucket; b<lastBucket; b++){
+        buckets[ (size_t)(b - firstBucket) ] = ring[ b % levelLength ];
+    }
+
+    view.level = level;
+    view.firstSample = firstBucket * samplesPerBucket;
+    view.samplesPerBucket = samplesPerBucket;
+
+    return true;
+}
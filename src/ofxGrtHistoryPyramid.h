@@ -0,0 +1,128 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+#include <vector>
+#include <cstddef>
+
+/**
+ @brief A mipmapped store of the complete history of a multi-channel timeseries with a fixed memory budget.
+ Level 0 holds the most recent levelLength samples at full resolution, and each level above it holds levelLength buckets
+ that each summarize reductionFactor buckets of the level below (their min, max and mean). Level k therefore covers
+ levelLength*reductionFactor^k samples, so a few levels are enough to keep hours of history while the memory used is
+ numChannels*levelLength*numLevels buckets whatever the number of samples pushed.
+
+ Samples are addressed by their absolute index (the first sample ever written is 0). Writing a sample is amortized O(1),
+ and getWindow returns any window at the finest level that holds it in at most maxBuckets buckets.
+*/
+class ofxGrtHistoryPyramid{
+public:
+    struct Bucket{
+        float min;
+        float max;
+        float mean;
+    };
+
+    struct View{
+        unsigned int level; ///< The level the buckets were read from
+        unsigned long long firstSample; ///< The absolute index of the first sample in the first bucket
+        unsigned long long samplesPerBucket; ///< The number of samples summarized by each bucket
+    };
+
+    ofxGrtHistoryPyramid();
+    ~ofxGrtHistoryPyramid();
+
+    /**
+     @brief allocates the levels and removes any existing history
+     @param numChannels: the number of channels in each sample
+     @param levelLength: the number of buckets stored at each level
+     @param numLevels: the number of levels, including the full resolution level
+     @param reductionFactor: the number of buckets from the level below that are summarized by each bucket, must be at least 2
+     @return returns true if the pyramid was setup successfully, false otherwise
+    */
+    bool setup( const unsigned int numChannels, const unsigned int levelLength, const unsigned int numLevels, const unsigned int reductionFactor = 4 );
+
+    /**
+     @brief removes all the history, keeping the current setup
+    */
+    void clear();
+
+    /**
+     @brief writes numFrames samples for one channel, starting at the current sample index. This must be called for every channel before calling advance
+     @param source: the first sample for the channel
+     @param stride: the distance between consecutive samples in the source
+    */
+    void write( const unsigned int channel, const float *source, const size_t stride, const size_t numFrames );
+
+    /**
+     @brief moves the current sample index on by numFrames, once the samples for every channel have been written
+    */
+    void advance( const size_t numFrames ){ numSamples += numFrames; }
+
+    /**
+     @brief gets the buckets covering the samples [start,end) for one channel, from the finest level that needs no more than maxBuckets buckets.
+     If that level no longer holds the start of the window then a coarser level is used, and if no level reaches back that far the window is
+     clipped to the oldest sample in the pyramid. The window only contains complete buckets, so up to one bucket of the newest samples may be missing.
+     @param buckets: the vector the buckets will be copied into, this will be resized to the number of buckets in the window
+     @param view: returns the level and sample position of the buckets
+     @return returns true if there were any buckets in the window, false otherwise
+    */
+    bool getWindow( const unsigned int channel, unsigned long long start, unsigned long long end, const unsigned int maxBuckets, std::vector< Bucket > &buckets, View &view ) const;
+
+    /**
+     @return returns the total number of samples written since the pyramid was setup or cleared
+    */
+    unsigned long long getNumSamples() const { return numSamples; }
+
+    /**
+     @return returns the absolute index of the oldest sample that is still summarized by the coarsest level
+    */
+    unsigned long long getOldestSample() const { return getOldestSample( numLevels > 0 ? numLevels-1 : 0 ); }
+
+    /**
+     @return returns the number of bytes used to store the levels
+    */
+    size_t getMemorySize() const { return (size_t)numChannels * levelLength * numLevels * sizeof( Bucket ); }
+
+    unsigned int getNumChannels() const { return numChannels; }
+    unsigned int getLevelLength() const { return levelLength; }
+    unsigned int getNumLevels() const { return numLevels; }
+    unsigned int getReductionFactor() const { return reductionFactor; }
+
+protected:
+    struct Accumulator{
+        float min;
+        float max;
+        double sum;
+    };
+
+    unsigned long long getSamplesPerBucket( const unsigned int level ) const { return levelScale[ level ]; }
+    unsigned long long getOldestSample( const unsigned int level ) const;
+
+    unsigned int numChannels;
+    unsigned int levelLength;
+    unsigned int numLevels;
+    unsigned int reductionFactor;
+    unsigned long long numSamples;
+    std::vector< unsigned long long > levelScale; ///< The number of samples in each bucket at each level (reductionFactor^level)
+    std::vector< std::vector< Bucket > > levels; ///< Channel-major rings, channel n of level k occupies [n*levelLength, (n+1)*levelLength) of levels[k]
+    std::vector< Accumulator > accumulators; ///< The partial bucket being built for each channel and level, indexed by channel*numLevels + level
+};
@@ -0,0 +1,182 @@
+#include "ofxGrtIngestQueue.h"
+#include <algorithm>
+#include <cstring>
+
+ofxGrtIngestQueue::ofxGrtIngestQueue(){
+    capacity = 0;
+    frameSize = 0;
+    policy = DROP_OLDEST;
+    writeIndex = 0;
+    readIndex = 0;
+    hasPendingFrame = false;
+    pendingState = FREE;
+    numDroppedFrames = 0;
+}
+
+ofxGrtIngestQueue::~ofxGrtIngestQueue(){
+}
+
+bool ofxGrtIngestQueue::setup( const unsigned int capacity, const unsigned int frameSize, const OverflowPolicy policy ){
+
+    this->capacity = 0;
+    slots.reset();
+
+    if( capacity == 0 || frameSize == 0 ) return false;
+
+    slots.reset( new Slot[ capacity ] );
+    for(unsigned int i=0; i<capacity; i++){
+        slots[i].state.store( FREE, std::memory_order_relaxed );
+        slots[i].sequence = 0;
+        slots[i].frame.data.resize( frameSize, 0 );
+        writeFrame( slots[i].frame, NULL, false, "", 0 );
+    }
+    hasPendingFrame = false;
+    pendingState.store( FREE, std::memory_order_relaxed );
+    pendingFrame.data.resize( frameSize, 0 );
+    writeFrame( pendingFrame, NULL, false, "", 0 );
+
+    this->capacity = capacity;
+    this->frameSize = frameSize;
+    this->policy = policy;
+    writeIndex = 0;
+    readIndex = 0;
+    numDroppedFrames = 0;
+
+    return true;
+}
+
+bool ofxGrtIngestQueue::push( const float *data, const bool highlight, const std::string &label, const uint64_t timestamp ){
+
+    if( capacity == 0 ) return false;
+
+    if( policy == COALESCE ) return pushCoalesced( data, highlight, label.c_str(), timestamp );
+
+    if( publish( data, highlight, label.c_str(), timestamp ) ) return true;
+
+    numDroppedFrames.fetch_add( 1, std::memory_order_relaxed );
+    return false;
+}
+
+bool ofxGrtIngestQueue::pushCoalesced( const float *data, const bool highlight, const char *label, const uint64_t timestamp ){
+
+    //The coalesced frame keeps the sequence it would have had in the queue (nothing is published while it is pending),
+    //so the consumer only takes it once every older frame has been read
+    if( hasPendingFrame ){
+        //Take the coalesced frame back and publish it first so the frames stay in order
+        unsigned long long state = getPendingState( writeIndex, READY );
+        if( pendingState.compare_exchange_strong( state, getPendingState( writeIndex, WRITING ), std::memory_order_acquire ) ){
+            if( !publish( &pendingFrame.data[0], pendingFrame.highlight, pendingFrame.label, pendingFrame.timestamp ) ){
+                //The queue is still full, so merge the new frame into the pending frame
+                writeFrame( pendingFrame, data, pendingFrame.highlight || highlight, label, timestamp );
+                pendingState.store( getPendingState( writeIndex, READY ), std::memory_order_release );
+                numDroppedFrames.fetch_add( 1, std::memory_order_relaxed );
+                return true;
+            }
+            pendingState.store( FREE, std::memory_order_release );
+        }else{
+            //The consumer has taken the frame, so its sequence has been used
+            writeIndex++;
+        }
+        hasPendingFrame = false;
+    }
+
+    if( publish( data, highlight, label, timestamp ) ) return true;
+
+    //The queue is full, the frame is held as the pending frame unless the consumer is still reading the previous pending frame
+    if( (pendingState.load( std::memory_order_acquire ) & PENDING_STATE_MASK) != FREE ){
+        numDroppedFrames.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+    }
+    //Only the producer moves the pending frame out of FREE, so there is no need for a CAS here
+    pendingState.store( getPendingState( writeIndex, WRITING ), std::memory_order_relaxed );
+    writeFrame( pendingFrame, data, highlight, label, timestamp );
+    pendingState.store( getPendingState( writeIndex, READY ), std::memory_order_release );
+    hasPendingFrame = true;
+
+    return true;
+}
+
+bool ofxGrtIngestQueue::publish( const float *data, const bool highlight, const char *label, const uint64_t timestamp ){
+
+    Slot &slot = slots[ writeIndex % capacity ];
+
+    int state = slot.state.load( std::memory_order_acquire );
+    if( state == READY && policy == DROP_OLDEST ){
+        //The queue is full and this slot holds the oldest unread frame, take it back unless the consumer claims it first
+        if( !slot.state.compare_exchange_strong( state, WRITING, std::memory_order_acquire ) ){
+            return false;
+        }
+        numDroppedFrames.fetch_add( 1, std::memory_order_relaxed );
+    }else if( state == FREE ){
+        //Only the producer moves a slot out of FREE, so there is no need for a CAS here
+        slot.state.store( WRITING, std::memory_order_relaxed );
+    }else{
+        return false;
+    }
+
+    writeFrame( slot.frame, data, highlight, label, timestamp );
+    slot.sequence = writeIndex++;
+    slot.state.store( READY, std::memory_order_release );
+
+    return true;
+}
+
+bool ofxGrtIngestQueue::pop( Frame &frame ){
+
+    if( capacity == 0 ) return false;
+
+    while( true ){
+        Slot &slot = slots[ readIndex % capacity ];
+
+        int state = READY;
+        if( !slot.state.compare_exchange_strong( state, READING, std::memory_order_acquire ) ){
+            //The queue is empty, so a coalesced frame still waiting for space is the newest frame
+            return policy == COALESCE && popPending( frame );
+        }
+
+        //If the producer has lapped this slot then the frame we expected was dropped, the newer frame will be read when we reach its index
+        if( slot.sequence != readIndex ){
+            slot.state.store( READY, std::memory_order_release );
+            readIndex++;
+            continue;
+        }
+
+        readFrame( slot.frame, frame );
+        slot.state.store( FREE, std::memory_order_release );
+        readIndex++;
+        return true;
+    }
+}
+
+bool ofxGrtIngestQueue::popPending( Frame &frame ){
+
+    //The CAS only succeeds if the pending frame is the next frame in order, otherwise the producer has published
+    //it (and maybe newer frames) since the queue was found empty and those will be read from the queue first
+    unsigned long long state = getPendingState( readIndex, READY );
+    if( !pendingState.compare_exchange_strong( state, getPendingState( readIndex, READING ), std::memory_order_acquire ) ){
+        return false;
+    }
+
+    readFrame( pendingFrame, frame );
+    pendingState.store( FREE, std::memory_order_release );
+    readIndex++;
+
+    return true;
+}
+
+void ofxGrtIngestQueue::writeFrame( Frame &frame, const float *data, const bool highlight, const char *label, const uint64_t timestamp ){
+    if( data ) std::copy( data, data+frameSize, frame.data.begin() );
+    frame.highlight = highlight;
+    const size_t length = strnlen( label, MAX_LABEL_LENGTH );
+    memcpy( frame.label, label, length );
+    frame.label[ length ] = '\0';
+    frame.timestamp = timestamp;
+}
+
+void ofxGrtIngestQueue::readFrame( const Frame &source, Frame &frame ) const {
+    frame.data.resize( frameSize );
+    std::copy( source.data.begin(), source.data.end(), frame.data.begin() );
+    frame.highlight = source.highlight;
+    memcpy( frame.label, source.label, sizeof(frame.label) );
+    frame.timestamp = source.timestamp;
+}
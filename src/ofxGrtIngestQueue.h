@@ -0,0 +1,119 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <atomic>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+/**
+ @brief A single-producer/single-consumer queue of plot frames (one value per channel plus a highlight flag, label and timestamp).
+ The producer (e.g. a sensor or audio thread) never blocks: push runs in a bounded number of steps whatever the consumer is doing.
+ The consumer (the draw thread) drains the queue with pop.
+
+ Each slot is owned by exactly one side at a time through its state, so the payload is never read while it is being written.
+ When the queue is full the overflow policy decides what happens to the new frame:
+ - DROP_OLDEST: the oldest unread frame is overwritten (if the consumer is reading that exact frame the new frame is dropped instead)
+ - DROP_NEWEST: the new frame is dropped
+ - COALESCE: the new frame is held in a pending slot and merged with any further overflowing frames (the latest values are kept
+   and the highlights are combined), the merged frame is published by the next push that finds space in the queue, or taken
+   by the consumer once it has emptied the queue, so the last frame is not lost if the producer goes quiet
+
+ Labels are copied into fixed size storage so push never allocates, labels longer than MAX_LABEL_LENGTH are truncated.
+*/
+class ofxGrtIngestQueue{
+public:
+    enum OverflowPolicy{ DROP_OLDEST=0, DROP_NEWEST, COALESCE };
+
+    enum{ MAX_LABEL_LENGTH=63 };
+
+    struct Frame{
+        std::vector< float > data;
+        bool highlight;
+        char label[ MAX_LABEL_LENGTH+1 ]; ///< The null terminated label, fixed size so copying a frame never allocates
+        uint64_t timestamp; ///< The time the frame was produced (in milliseconds), so queued frames keep their own time
+    };
+
+    ofxGrtIngestQueue();
+    ~ofxGrtIngestQueue();
+
+    /**
+     @brief allocates the queue, this must not be called while a producer or consumer is using the queue
+     @param capacity: the maximum number of frames that can be waiting in the queue
+     @param frameSize: the number of values in each frame (the number of channels in the plot)
+     @param policy: sets what happens to new frames when the queue is full
+     @return returns true if the queue was setup successfully, false otherwise
+    */
+    bool setup( const unsigned int capacity, const unsigned int frameSize, const OverflowPolicy policy = DROP_OLDEST );
+
+    /**
+     @brief pushes a frame into the queue, this should only be called from the producer thread
+     @param data: a pointer to frameSize values
+     @param timestamp: the time the frame was produced (in milliseconds)
+     @return returns true if the frame was queued (or coalesced), false if it was dropped
+    */
+    bool push( const float *data, const bool highlight, const std::string &label, const uint64_t timestamp );
+
+    /**
+     @brief pops the oldest frame from the queue (or the coalesced frame once the queue is empty), this should only be called from the consumer thread
+     @param frame: the frame the data will be copied into, its data vector will be resized to frameSize
+     @return returns true if a frame was popped, false if the queue was empty
+    */
+    bool pop( Frame &frame );
+
+    /**
+     @return returns the number of frames that have been dropped because the queue was full
+    */
+    unsigned long long getNumDroppedFrames() const { return numDroppedFrames.load( std::memory_order_relaxed ); }
+
+    unsigned int getCapacity() const { return capacity; }
+    unsigned int getFrameSize() const { return frameSize; }
+    OverflowPolicy getOverflowPolicy() const { return policy; }
+
+protected:
+    enum SlotState{ FREE=0, WRITING, READY, READING };
+    enum{ PENDING_STATE_BITS=2, PENDING_STATE_MASK=3 };
+
+    struct Slot{
+        std::atomic< int > state;
+        unsigned long long sequence; ///< The producer index of the frame in this slot, written before the slot is marked READY
+        Frame frame;
+    };
+
+    bool pushCoalesced( const float *data, const bool highlight, const char *label, const uint64_t timestamp );
+    bool publish( const float *data, const bool highlight, const char *label, const uint64_t timestamp );
+    bool popPending( Frame &frame );
+    static unsigned long long getPendingState( const unsigned long long sequence, const SlotState state ){ return (sequence << PENDING_STATE_BITS) | state; }
+    void writeFrame( Frame &frame, const float *data, const bool highlight, const char *label, const uint64_t timestamp );
+    void readFrame( const Frame &source, Frame &frame ) const;
+
+    unsigned int capacity;
+    unsigned int frameSize;
+    OverflowPolicy policy;
+    std::unique_ptr< Slot[] > slots;
+    unsigned long long writeIndex; ///< Only accessed by the producer
+    unsigned long long readIndex; ///< Only accessed by the consumer
+    bool hasPendingFrame; ///< Only accessed by the producer, true if the producer has left a coalesced frame in pendingFrame
+    std::atomic< unsigned long long > pendingState; ///< The SlotState of pendingFrame in the low bits and the sequence the frame will take above them
+    Frame pendingFrame; ///< Holds the coalesced frame while the queue is full
+    std::atomic< unsigned long long > numDroppedFrames;
+};
@@ -1,5 +1,6 @@
 
 #include "ofxGrtMatrixPlot.h"
+#include "ofxGrtNormalize.h"
 
 using namespace GRT;
 
@@ -9,6 +10,15 @@ ofxGrtMatrixPlot::ofxGrtMatrixPlot( const std::string &title, const ofTrueTypeFo
     this->rows = 0;
     this->cols = 0;
     this->textColor = textColor;
+    sampleFormat = textureFormat = OFXGRT_SAMPLE_FLOAT;
+    scrollOffset = 0;
+    bufferUploaded = false;
+    asyncUpload = false;
+    tiled = false;
+    tileSize = 0;
+    viewRow = viewCol = viewRows = viewCols = 0;
+    boundData = NULL;
+    boundRows = boundCols = boundStride = 0;
     config = ofxGrtSettings::GetInstance().get();
     if( font == NULL ) this->font = &config->fontNormal;
     if( title != "" ) setTitle( title );
@@ -23,6 +33,15 @@ ofxGrtMatrixPlot::ofxGrtMatrixPlot(const std::string &plotTitle, const std::stri
     textColor = config->activeTextColor;
     font = &config->fontNormal;
     rows = cols = 0;
+    sampleFormat = textureFormat = OFXGRT_SAMPLE_FLOAT;
+    scrollOffset = 0;
+    bufferUploaded = false;
+    asyncUpload = false;
+    tiled = false;
+    tileSize = 0;
+    viewRow = viewCol = viewRows = viewCols = 0;
+    boundData = NULL;
+    boundRows = boundCols = boundStride = 0;
 }
 
 bool ofxGrtMatrixPlot::resize( const unsigned int rows, const unsigned int cols ){
@@ -33,188 +52,595 @@ bool ofxGrtMatrixPlot::resize( const unsigned int rows, const unsigned int cols
     pixelData.resize( size );
 
     for(unsigned int i=0; i<size; i++){
-        pixelData[ i++ ] = 0.0;
+        pixelData[ i ] = 0.0;
     }
 
-    const unsigned int width = cols;
-    const unsigned int height = rows;
-    pixels.setFromExternalPixels(&pixelData[0],width,height,OF_PIXELS_GRAY);
+    return update( &pixelData[0], rows, cols );
+}
 
-    if(!texture.isAllocated()){
-        texture.allocate( pixels, false );
-        texture.setRGToRGBASwizzles(true);
-    }
-    texture.loadData( pixels );
-    texture.setTextureMinMagFilter( GL_LINEAR, GL_LINEAR );
+bool ofxGrtMatrixPlot::update( const Matrix<double> &data ){
+    return updateMatrix( data, 0.0f, 1.0f );
+}
 
-    return true;
+bool ofxGrtMatrixPlot::update( const Matrix<float> &data ){
+    //The float matrix is contiguous, so it is copied a row at a time by the vectorized scale rather than element by element
+    if( data.getNumRows() == 0 || data.getNumCols() == 0 ) return false;
+    return updateScaled( data.getData(), data.getNumRows(), data.getNumCols(), 0.0f, 1.0f );
 }
 
-bool ofxGrtMatrixPlot::update( const Matrix<double> &data ){
+bool ofxGrtMatrixPlot::update( const MatrixFloat &data, const float minValue, const float maxValue ){
+    return updateMatrix( data, minValue, maxValue );
+}
+
+template< class MatrixType > bool ofxGrtMatrixPlot::updateMatrix( const MatrixType &data, const float minValue, const float maxValue ){
 
     const unsigned int rows = data.getNumRows();
     const unsigned int cols = data.getNumCols();
-    const size_t size = rows*cols;
-
-    if( this->rows != rows || this->cols != cols ){
-        this->rows = rows;
-        this->cols = cols;
-        pixelData.resize( size );
+    const size_t size = (size_t)rows*cols;
+    if( size == 0 ) return false;
+
+    //If the texture still holds the last matrix at this size, only the bounding box of the cells that changed is uploaded
+    const bool partial = bufferUploaded && canUpdateRegion( rows, cols );
+    dirtyRegion.clear();
+
+    //The compact formats are quantized straight from the matrix rows, without going through the float buffer
+    if( sampleFormat != OFXGRT_SAMPLE_FLOAT ){
+        packedData.resize( size * ofxGrtGetSampleSize( sampleFormat ) );
+        for(unsigned int i=0; i<rows; i++){
+            packRow( data[i], (size_t)i*cols, cols, minValue, maxValue, partial ? &dirtyRegion : NULL, i );
+        }
+        return finishUpdate( partial, rows, cols );
     }
 
+    pixelData.resize( size );
+    const float scale = maxValue > minValue ? 1.0f / (maxValue - minValue) : 0.0f;
     unsigned int index = 0;
     for(unsigned int i=0; i<rows; i++){
         for(unsigned int j=0; j<cols; j++){
-            pixelData[ index++ ] = data[i][j];
+            const float value = (float)(data[i][j] - minValue) * scale;
+            if( partial && value != pixelData[ index ] ) dirtyRegion.add( i, j );
+            pixelData[ index++ ] = value;
         }
     }
-    float *pixelPointer = &pixelData[0];
 
-    return update( pixelPointer, rows, cols );
+    return finishUpdate( partial, rows, cols );
 }
 
-bool ofxGrtMatrixPlot::update( const Matrix<float> &data ){
+bool ofxGrtMatrixPlot::updateNormalized( const MatrixFloat &data ){
+    return updateNormalizedRows( data.getData(), data.getNumRows(), data.getNumCols(), data.getNumCols() );
+}
 
-    const unsigned int rows = data.getNumRows();
-    const unsigned int cols = data.getNumCols();
-    const size_t size = rows*cols;
+bool ofxGrtMatrixPlot::updateNormalized( const float *data, const unsigned int rows, const unsigned int cols, const unsigned int rowStride ){
+    return updateNormalizedRows( data, rows, cols, rowStride );
+}
 
-    if( this->rows != rows || this->cols != cols ){
-        this->rows = rows;
-        this->cols = cols;
-        pixelData.resize( size );
-    }
+bool ofxGrtMatrixPlot::updateNormalized( const double *data, const unsigned int rows, const unsigned int cols, const unsigned int rowStride ){
+    return updateNormalizedRows( data, rows, cols, rowStride );
+}
 
-    unsigned int index = 0;
+template< class T > bool ofxGrtMatrixPlot::updateNormalizedRows( const T *data, const unsigned int rows, const unsigned int cols, const unsigned int rowStride ){
+
+    const unsigned int stride = rowStride == 0 ? cols : rowStride;
+    if( data == NULL || rows == 0 || cols == 0 || stride < cols ) return false;
+
+    //The range can only be known once every value has been read, so the rows are copied (and converted to float) into packed rows while the range is found,
+    //then scaled from the packed rows, this reads the input matrix once however it is strided
+    normalizeScratch.resize( (size_t)rows*cols );
+    float minValue = std::numeric_limits< float >::max();
+    float maxValue = -std::numeric_limits< float >::max();
     for(unsigned int i=0; i<rows; i++){
-        for(unsigned int j=0; j<cols; j++){
-            pixelData[ index++ ] = data[i][j];
-        }
+        ofxGrtCopyRange( data + (size_t)i*stride, &normalizeScratch[ (size_t)i*cols ], cols, minValue, maxValue );
     }
-    float *pixelPointer = &pixelData[0];
 
-    return update( pixelPointer, rows, cols );
+    //If every value is NaN there is no range, the plot is then filled with the NaN values
+    if( minValue > maxValue ) minValue = maxValue = 0.0f;
+
+    return updateScaled( &normalizeScratch[0], rows, cols, minValue, maxValue );
 }
 
-bool ofxGrtMatrixPlot::update( const MatrixFloat &data, const float minValue, const float maxValue ){
+bool ofxGrtMatrixPlot::updateScaled( const float *data, const unsigned int rows, const unsigned int cols, const float minValue, const float maxValue ){
 
-    const unsigned int rows = data.getNumRows();
-    const unsigned int cols = data.getNumCols();
-    const size_t size = rows*cols;
+    const size_t size = (size_t)rows*cols;
+    const bool partial = bufferUploaded && canUpdateRegion( rows, cols );
+    dirtyRegion.clear();
 
-    if( this->rows != rows || this->cols != cols ){
-        this->rows = rows;
-        this->cols = cols;
-        pixelData.resize( size );
+    if( sampleFormat != OFXGRT_SAMPLE_FLOAT ){
+        packedData.resize( size * ofxGrtGetSampleSize( sampleFormat ) );
+        for(unsigned int i=0; i<rows; i++){
+            packRow( data + (size_t)i*cols, (size_t)i*cols, cols, minValue, maxValue, partial ? &dirtyRegion : NULL, i );
+        }
+        return finishUpdate( partial, rows, cols );
     }
 
-    unsigned int index = 0;
+    pixelData.resize( size );
+    const float scale = maxValue > minValue ? 1.0f / (maxValue - minValue) : 0.0f;
+    unsigned int firstChanged = 0;
+    unsigned int lastChanged = 0;
     for(unsigned int i=0; i<rows; i++){
-        for(unsigned int j=0; j<cols; j++){
-            pixelData[ index++ ] = Util::scale(data[i][j],minValue,maxValue,0.0,1.0);
+        if( ofxGrtScaleRange( data + (size_t)i*cols, &pixelData[ (size_t)i*cols ], cols, minValue, scale, partial, firstChanged, lastChanged ) ){
+            dirtyRegion.add( i, firstChanged );
+            dirtyRegion.add( i, lastChanged );
         }
     }
-    float *pixelPointer = &pixelData[0];
 
-    return update( pixelPointer, rows, cols );
+    return finishUpdate( partial, rows, cols );
+}
+
+bool ofxGrtMatrixPlot::finishUpdate( const bool partial, const unsigned int rows, const unsigned int cols ){
+
+    //pixelData (or packedData) now holds the new matrix, either all of it is uploaded or just the dirty region
+    const bool compact = sampleFormat != OFXGRT_SAMPLE_FLOAT;
+    if( partial ){
+        uploadRegion( compact ? (const void*)&packedData[0] : (const void*)&pixelData[0], dirtyRegion );
+    }else if( compact ){
+        if( !uploadPacked( rows, cols ) ) return false;
+    }else{
+        if( !update( &pixelData[0], rows, cols ) ) return false;
+    }
+    bufferUploaded = true;
+
+    return true;
 }
 
 bool ofxGrtMatrixPlot::update( float *data, const unsigned int rows, const unsigned int cols ){
 
+    if( sampleFormat != OFXGRT_SAMPLE_FLOAT ){
+        packedData.resize( (size_t)rows * cols * ofxGrtGetSampleSize( sampleFormat ) );
+        packRow( data, 0, rows*cols, 0.0f, 1.0f );
+        if( !uploadPacked( rows, cols ) ) return false;
+        bufferUploaded = true;
+        return true;
+    }
+
+    //The tiles are uploaded lazily as they are drawn, so they need a copy of the matrix that the caller can not free
+    if( useTiles( rows, cols ) && (pixelData.empty() || data != &pixelData[0]) ){
+        pixelData.assign( data, data + (size_t)rows*cols );
+        data = &pixelData[0];
+    }
+
+    this->rows = rows;
+    this->cols = cols;
     const unsigned int width = cols;
     const unsigned int height = rows;
     pixels.setFromExternalPixels(data,width,height,OF_PIXELS_GRAY);
 
-    if(!texture.isAllocated()){
-        texture.allocate( pixels, false );
-        texture.setRGToRGBASwizzles(true);
+    if( !uploadFull( data, rows, cols ) ) return false;
+    bufferUploaded = false;
+
+    return true;
+}
+
+bool ofxGrtMatrixPlot::update( float *data, const unsigned int rows, const unsigned int cols, const unsigned int firstRow, const unsigned int firstCol, const unsigned int numRows, const unsigned int numCols ){
+
+    if( data == NULL || firstRow + numRows > rows || firstCol + numCols > cols ) return false;
+
+    //The region can only be uploaded on its own if the texture already holds a matrix of this size in order
+    const bool partial = canUpdateRegion( rows, cols );
+    if( !partial ) return update( data, rows, cols );
+    if( numRows == 0 || numCols == 0 ) return true;
+
+    dirtyRegion.clear();
+    dirtyRegion.add( firstRow, firstCol );
+    dirtyRegion.add( firstRow + numRows - 1, firstCol + numCols - 1 );
+
+    if( sampleFormat != OFXGRT_SAMPLE_FLOAT ){
+        //Only the region is quantized, the rest of the packed buffer still mirrors the texture
+        packedData.resize( (size_t)rows * cols * ofxGrtGetSampleSize( sampleFormat ) );
+        for(unsigned int i=firstRow; i<firstRow+numRows; i++){
+            packRow( data + (size_t)i*cols + firstCol, (size_t)i*cols + firstCol, numCols, 0.0f, 1.0f );
+        }
+        return uploadRegion( &packedData[0], dirtyRegion );
     }
-    texture.loadData( pixels );
-    texture.setTextureMinMagFilter( GL_LINEAR, GL_LINEAR );
 
+    //The texture no longer matches the float buffer, so the next matrix update uploads everything (the tiles copy the region into the float buffer, so they still match)
+    bufferUploaded = tiled;
+    return uploadRegion( data, dirtyRegion );
+}
+
+bool ofxGrtMatrixPlot::bindBuffer( const float *data, const unsigned int rows, const unsigned int cols, const unsigned int rowStride ){
+
+    const unsigned int stride = rowStride == 0 ? cols : rowStride;
+    if( data == NULL || rows == 0 || cols == 0 || stride < cols ) return false;
+
+    boundData = data;
+    boundRows = rows;
+    boundCols = cols;
+    boundStride = stride;
+
+    return uploadBound( NULL );
+}
+
+bool ofxGrtMatrixPlot::unbindBuffer(){
+    boundData = NULL;
+    boundRows = boundCols = boundStride = 0;
     return true;
 }
 
-bool ofxGrtMatrixPlot::draw(const float x, const float y) const{
-    if( pixels.size() == 0 ) return false;
-    return draw(x, y, texture.getWidth(), texture.getHeight());
+bool ofxGrtMatrixPlot::markDirty(){
+    if( boundData == NULL ) return false;
+    return uploadBound( NULL );
 }
 
-bool ofxGrtMatrixPlot::draw(const float x, const float y, const float w, const float h) const{
+bool ofxGrtMatrixPlot::markDirty( const unsigned int firstRow, const unsigned int firstCol, const unsigned int numRows, const unsigned int numCols ){
 
-    if( pixels.size() == 0 ) return false;
+    if( boundData == NULL || firstRow + numRows > boundRows || firstCol + numCols > boundCols ) return false;
+    if( numRows == 0 || numCols == 0 ) return true;
 
-    //Draw the texture
-    texture.draw(x,y,w,h);
+    //If anything else has been drawn since the buffer was bound, the whole buffer is uploaded again
+    if( !canUpdateRegion( boundRows, boundCols ) ) return uploadBound( NULL );
 
-    //Draw the text
-    if( plotTitle != "" ){
+    Region region;
+    region.clear();
+    region.add( firstRow, firstCol );
+    region.add( firstRow + numRows - 1, firstCol + numCols - 1 );
 
-        ofSetColor(textColor);
-        float textX = x + w*0.5;
-        float textY = y-config->titleTextSpacer;//tempY + 5 + (font->getLineHeight()*0.5);
-        ofRectangle bounds;
+    return uploadBound( &region );
+}
 
-        if( font ){
-            if( !font->isLoaded() ) return false;
+bool ofxGrtMatrixPlot::uploadBound( const Region *region ){
 
-            textY = y + (font->getLineHeight()*0.5);
-            bounds = font->getStringBoundingBox( plotTitle, 0, 0 );
-            font->drawString( plotTitle, textX - bounds.width*0.5 , textY + bounds.height );
+    const unsigned int rows = boundRows;
+    const unsigned int cols = boundCols;
 
-            ofPushMatrix();
-            {
-                ofRotateZ(-90.0f);
-                font->drawString(yAxisInfo, -(textY+h)+config->info_margin-config->titleTextSpacer, textX-config->titleTextSpacer);
+    //The compact formats have to be quantized, so only these pay for a copy (of the dirty rows) into the packed buffer
+    if( sampleFormat != OFXGRT_SAMPLE_FLOAT ){
+        packedData.resize( (size_t)rows * cols * ofxGrtGetSampleSize( sampleFormat ) );
+        if( region != NULL ){
+            const unsigned int numCols = region->lastCol - region->firstCol + 1;
+            for(unsigned int i=region->firstRow; i<=region->lastRow; i++){
+                packRow( boundData + (size_t)i*boundStride + region->firstCol, (size_t)i*cols + region->firstCol, numCols, 0.0f, 1.0f );
             }
-            ofPopMatrix();
+            return uploadRegion( &packedData[0], *region );
+        }
+        for(unsigned int i=0; i<rows; i++){
+            packRow( boundData + (size_t)i*boundStride, (size_t)i*cols, cols, 0.0f, 1.0f );
+        }
+        if( !uploadPacked( rows, cols ) ) return false;
+        bufferUploaded = true;
+        return true;
+    }
+
+    //The tiles are uploaded lazily and read the matrix from the float buffer, so a tiled matrix is copied (the region copy is done by uploadRegion)
+    if( useTiles( rows, cols ) ){
+        if( region != NULL ) return uploadRegion( boundData, *region, boundStride );
+        pixelData.resize( (size_t)rows*cols );
+        for(unsigned int i=0; i<rows; i++){
+            memcpy( &pixelData[ (size_t)i*cols ], boundData + (size_t)i*boundStride, cols*sizeof(float) );
+        }
+        if( !update( &pixelData[0], rows, cols ) ) return false;
+        bufferUploaded = true;
+        return true;
+    }
+
+    //The texture now holds the bound buffer rather than the float buffer
+    bufferUploaded = false;
+    if( region != NULL ) return uploadRegion( boundData, *region, boundStride );
+
+    if( tiled ){
+        tiles.clear();
+        tiled = false;
+    }
+    this->rows = rows;
+    this->cols = cols;
+    if( !allocateTexture( rows, cols ) ) return false;
+    scrollOffset = 0;
 
-            font->drawString( xAxisInfo, textX, textY+h+font->getLineHeight()-config->info_margin+config->titleTextSpacer );
+    if( asyncUpload && boundStride == cols ) return uploader.upload( texture, boundData, cols, rows, GL_RED, GL_FLOAT, sizeof(float) );
 
-        }else{
-            ofDrawBitmapString( plotTitle, textX, textY );
+    Region all;
+    all.clear();
+    all.add( 0, 0 );
+    all.add( rows-1, cols-1 );
+    return uploadRegion( boundData, all, boundStride );
+}
+
+bool ofxGrtMatrixPlot::pushColumn( const float *column ){
+
+    if( column == NULL || !texture.isAllocated() || rows == 0 || cols == 0 ) return false;
+    if( texture.getWidth() != cols || texture.getHeight() != rows ) return false;
+
+    //A column is rows texels, one per texture row, so the column data can be uploaded as a 1 x rows sub image
+    const void *data = column;
+    if( sampleFormat != OFXGRT_SAMPLE_FLOAT ){
+        packedData.resize( (size_t)rows * ofxGrtGetSampleSize( sampleFormat ) );
+        packRow( column, 0, rows, 0.0f, 1.0f );
+        data = &packedData[0];
+    }
+
+    const ofTextureData &textureData = texture.getTextureData();
+    glBindTexture( textureData.textureTarget, textureData.textureID );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+    glTexSubImage2D( textureData.textureTarget, 0, scrollOffset, 0, 1, rows, GL_RED, getGlType(), data );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+    glBindTexture( textureData.textureTarget, 0 );
+
+    //The slot that was just written is now the newest column, so the oldest column is the next one
+    if( ++scrollOffset == cols ) scrollOffset = 0;
+    bufferUploaded = false;
+
+    return true;
+}
+
+bool ofxGrtMatrixPlot::setSampleFormat( const ofxGrtSampleFormat format ){
+    sampleFormat = format;
+    return true;
+}
+
+ofxGrtSampleFormat ofxGrtMatrixPlot::getSampleFormat() const{
+    return sampleFormat;
+}
+
+bool ofxGrtMatrixPlot::setAsyncUpload( const bool enabled ){
+    asyncUpload = enabled;
+    if( !asyncUpload ) uploader.clear();
+    return true;
+}
+
+bool ofxGrtMatrixPlot::getAsyncUpload() const{
+    return asyncUpload;
+}
+
+bool ofxGrtMatrixPlot::setTileSize( const unsigned int tileSize ){
+    this->tileSize = tileSize;
+    return true;
+}
+
+bool ofxGrtMatrixPlot::getIsTiled() const{
+    return tiled;
+}
+
+bool ofxGrtMatrixPlot::setViewport( const float firstRow, const float firstCol, const float numRows, const float numCols ){
+    if( numRows <= 0 || numCols <= 0 ) return false;
+    viewRow = firstRow;
+    viewCol = firstCol;
+    viewRows = numRows;
+    viewCols = numCols;
+    return true;
+}
+
+bool ofxGrtMatrixPlot::resetViewport(){
+    viewRow = viewCol = viewRows = viewCols = 0;
+    return true;
+}
+
+ofxGrtMatrixTiles& ofxGrtMatrixPlot::getTiles(){
+    return tiles;
+}
+
+template< class T > void ofxGrtMatrixPlot::packRow( const T *row, const size_t offset, const unsigned int count, const float minValue, const float maxValue, Region *dirty, const unsigned int rowIndex ){
+
+    if( count == 0 ) return;
+
+    const float scale = maxValue > minValue ? 1.0f / (maxValue - minValue) : 0.0f;
+
+    //If dirty is not NULL, then the packed buffer holds the matrix in the texture and any cell whose packed value changes is added to the dirty region
+    switch( sampleFormat ){
+        case OFXGRT_SAMPLE_UINT8:
+        {
+            unsigned char *dest = &packedData[0] + offset;
+            for(unsigned int i=0; i<count; i++){
+                const float v = (float)(row[i] - minValue) * scale;
+                const unsigned char q = (unsigned char)( (v >= 0.0f ? (v <= 1.0f ? v : 1.0f) : 0.0f) * 255.0f + 0.5f ); //NaN is stored as 0
+                if( dirty && dest[i] != q ) dirty->add( rowIndex, i );
+                dest[i] = q;
+            }
+        }
+        break;
+        case OFXGRT_SAMPLE_INT16:
+        {
+            unsigned short *dest = reinterpret_cast< unsigned short* >( &packedData[0] ) + offset;
+            for(unsigned int i=0; i<count; i++){
+                const float v = (float)(row[i] - minValue) * scale;
+                const unsigned short q = (unsigned short)( (v >= 0.0f ? (v <= 1.0f ? v : 1.0f) : 0.0f) * 65535.0f + 0.5f );
+                if( dirty && dest[i] != q ) dirty->add( rowIndex, i );
+                dest[i] = q;
+            }
+        }
+        break;
+        case OFXGRT_SAMPLE_HALF:
+        {
+            //Half textures are not normalized, so like the float texture the values are not clamped
+            unsigned short *dest = reinterpret_cast< unsigned short* >( &packedData[0] ) + offset;
+            for(unsigned int i=0; i<count; i++){
+                const unsigned short q = ofxGrtFloatToHalf( (float)(row[i] - minValue) * scale );
+                if( dirty && dest[i] != q ) dirty->add( rowIndex, i );
+                dest[i] = q;
+            }
         }
+        break;
+        default:
+        break;
+    }
+}
+
+bool ofxGrtMatrixPlot::uploadPacked( const unsigned int rows, const unsigned int cols ){
+
+    this->rows = rows;
+    this->cols = cols;
+
+    return uploadFull( &packedData[0], rows, cols );
+}
+
+bool ofxGrtMatrixPlot::uploadFull( const void *data, const unsigned int rows, const unsigned int cols ){
+
+    scrollOffset = 0;
+    if( useTiles( rows, cols ) ){
+        if( texture.isAllocated() ) texture.clear();
+        tiled = true;
+        textureFormat = sampleFormat;
+        return tiles.setup( data, rows, cols, sampleFormat, tileSize > 0 ? tileSize : DEFAULT_TILE_SIZE );
+    }
+    if( tiled ){
+        tiles.clear();
+        tiled = false;
     }
 
+    if( !allocateTexture( rows, cols ) ) return false;
+
+    if( asyncUpload ) return uploader.upload( texture, data, cols, rows, GL_RED, getGlType(), ofxGrtGetSampleSize( sampleFormat ) );
+
+    texture.loadData( data, cols, rows, GL_RED, getGlType() );
+
     return true;
 }
 
+bool ofxGrtMatrixPlot::uploadRegion( const void *data, const Region &region, const unsigned int rowLength ){
+
+    if( region.isEmpty() ) return true;
+
+    const size_t texelSize = ofxGrtGetSampleSize( sampleFormat );
+    const unsigned int stride = rowLength == 0 ? cols : rowLength;
+
+    if( tiled ){
+        //The tiles read the matrix from the plot's own buffer, so a region passed in from outside is copied into it first
+        unsigned char *buffer = sampleFormat == OFXGRT_SAMPLE_FLOAT ? reinterpret_cast< unsigned char* >( &pixelData[0] ) : &packedData[0];
+        if( data != buffer ){
+            const size_t rowSize = (region.lastCol - region.firstCol + 1) * texelSize;
+            for(unsigned int i=region.firstRow; i<=region.lastRow; i++){
+                const unsigned char *source = static_cast< const unsigned char* >( data ) + ((size_t)i*stride + region.firstCol) * texelSize;
+                memcpy( buffer + ((size_t)i*cols + region.firstCol) * texelSize, source, rowSize );
+            }
+        }
+        return tiles.update( region.firstRow, region.firstCol, region.lastRow, region.lastCol );
+    }
+
+    const ofTextureData &textureData = texture.getTextureData();
+    glBindTexture( textureData.textureTarget, textureData.textureID );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+#ifndef TARGET_OPENGLES
+    //The region is read straight out of the full matrix, the row length tells GL to step over the columns outside the region
+    const unsigned int numCols = region.lastCol - region.firstCol + 1;
+    const unsigned char *first = static_cast< const unsigned char* >( data ) + ((size_t)region.firstRow*stride + region.firstCol) * texelSize;
+    glPixelStorei( GL_UNPACK_ROW_LENGTH, stride );
+    glTexSubImage2D( textureData.textureTarget, 0, region.firstCol, region.firstRow, numCols, region.lastRow - region.firstRow + 1, GL_RED, getGlType(), first );
+    glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+#else
+    //GLES 2 has no unpack row length, so the full width of the dirty rows is uploaded, one row at a time if the rows are padded
+    const unsigned char *first = static_cast< const unsigned char* >( data ) + (size_t)region.firstRow*stride * texelSize;
+    if( stride == cols ){
+        glTexSubImage2D( textureData.textureTarget, 0, 0, region.firstRow, cols, region.lastRow - region.firstRow + 1, GL_RED, getGlType(), first );
+    }else{
+        for(unsigned int i=region.firstRow; i<=region.lastRow; i++){
+            glTexSubImage2D( textureData.textureTarget, 0, 0, i, cols, 1, GL_RED, getGlType(), first + (size_t)(i - region.firstRow)*stride * texelSize );
+        }
+    }
+#endif
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+    glBindTexture( textureData.textureTarget, 0 );
+
+    return true;
+}
+
+GLenum ofxGrtMatrixPlot::getGlType() const{
+    return ofxGrtMatrixTiles::getGlType( sampleFormat );
+}
+
+bool ofxGrtMatrixPlot::canUpdateRegion( const unsigned int rows, const unsigned int cols ) const{
+    if( this->rows != rows || this->cols != cols || scrollOffset != 0 || textureFormat != sampleFormat ) return false;
+    return tiled ? tiles.getIsSetup() : texture.isAllocated();
+}
+
+bool ofxGrtMatrixPlot::useTiles( const unsigned int rows, const unsigned int cols ) const{
+
+    if( tileSize > 0 ) return true;
+
+    //Matrices larger than the GPU can hold in one texture are always tiled
+    static GLint maxTextureSize = 0;
+    if( maxTextureSize == 0 ) glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxTextureSize );
+    return maxTextureSize > 0 && (rows > (unsigned int)maxTextureSize || cols > (unsigned int)maxTextureSize);
+}
+
+bool ofxGrtMatrixPlot::allocateTexture( const unsigned int rows, const unsigned int cols ){
+
+    if( rows == 0 || cols == 0 ) return false;
+
+    //The texture (and its filters) is only recreated if the size or format changes, otherwise the new data is uploaded into the existing texture
+    if( texture.isAllocated() && textureFormat == sampleFormat && texture.getWidth() == cols && texture.getHeight() == rows ) return true;
+
+    texture.allocate( cols, rows, ofxGrtMatrixTiles::getGlInternalFormat( sampleFormat ) );
+    texture.setRGToRGBASwizzles(true);
+    texture.setTextureMinMagFilter( GL_LINEAR, GL_LINEAR );
+    textureFormat = sampleFormat;
+
+    return true;
+}
+
+bool ofxGrtMatrixPlot::draw(const float x, const float y) const{
+    if( !texture.isAllocated() && !tiled ) return false;
+    return draw(x, y, cols, rows);
+}
+
+bool ofxGrtMatrixPlot::draw(const float x, const float y, const float w, const float h) const{
+
+    if( !texture.isAllocated() && !tiled ) return false;
+
+    //Draw the texture
+    drawTexture(x,y,w,h);
+
+    //Draw the text
+    return drawText(x,y,w,h);
+}
+
 bool ofxGrtMatrixPlot::draw(const float x, const float y, const float w, const float h,const ofShader &shader) const{
 
-    if( pixels.size() == 0 ) return false;
+    if( !texture.isAllocated() && !tiled ) return false;
 
     //Set the shader and draw the texture
     shader.begin();
-    texture.draw(x,y,w,h);
+    drawTexture(x,y,w,h);
     shader.end();
 
     //Draw the text
-    if( plotTitle != "" ){
+    return drawText(x,y,w,h);
+}
+
+void ofxGrtMatrixPlot::drawTexture(const float x, const float y, const float w, const float h) const{
 
-        ofSetColor(textColor);
-        float textX = x + w*0.5;
-        float textY = y-config->titleTextSpacer;//tempY + 5 + (font->getLineHeight()*0.5);
-        ofRectangle bounds;
+    if( tiled ){
+        if( viewRows > 0 && viewCols > 0 ) tiles.draw( x, y, w, h, viewRow, viewCol, viewRows, viewCols );
+        else tiles.draw( x, y, w, h, 0, 0, rows, cols );
+        return;
+    }
 
-        if( font ){
-            if( !font->isLoaded() ) return false;
+    if( scrollOffset == 0 ){
+        texture.draw(x,y,w,h);
+        return;
+    }
 
-            textY = y + (font->getLineHeight()*0.5);
-            bounds = font->getStringBoundingBox( plotTitle, 0, 0 );
-            font->drawString( plotTitle, textX - bounds.width*0.5 , textY + bounds.height );
+    //The ring starts at the scrollOffset column, so the columns [scrollOffset,cols) are drawn first and the columns [0,scrollOffset) after them
+    const float oldestCols = (float)(cols - scrollOffset);
+    const float oldestWidth = w * oldestCols / cols;
+    texture.drawSubsection( x, y, oldestWidth, h, scrollOffset, 0, oldestCols, rows );
+    texture.drawSubsection( x + oldestWidth, y, w - oldestWidth, h, 0, 0, scrollOffset, rows );
+}
 
-            ofPushMatrix();
-            {
-                ofRotateZ(-90.0f);
-                font->drawString(yAxisInfo, -(textY+h)+config->info_margin-config->titleTextSpacer, textX-config->titleTextSpacer);
-            }
-            ofPopMatrix();
+bool ofxGrtMatrixPlot::drawText(const float x, const float y, const float w, const float h) const{
 
-            font->drawString( xAxisInfo, textX, textY+h+font->getLineHeight()-config->info_margin+config->titleTextSpacer );
+    if( plotTitle == "" ) return true;
 
-        }else{
-            ofDrawBitmapString( plotTitle, textX, textY );
+    ofSetColor(textColor);
+    float textX = x + w*0.5;
+    float textY = y-config->titleTextSpacer;//tempY + 5 + (font->getLineHeight()*0.5);
+
+    if( font ){
+        if( !font->isLoaded() ) return false;
+
+        //The title and axis text rarely change, so they are drawn from the cached glyph meshes
+        textY = y + (font->getLineHeight()*0.5);
+        const ofRectangle bounds = textCache.getStringBoundingBox( font, plotTitle );
+        textCache.drawString( font, plotTitle, textX - bounds.width*0.5 , textY + bounds.height );
+
+        ofPushMatrix();
+        {
+            ofRotateZ(-90.0f);
+            textCache.drawString( font, yAxisInfo, -(textY+h)+config->info_margin-config->titleTextSpacer, textX-config->titleTextSpacer );
         }
+        ofPopMatrix();
+
+        textCache.drawString( font, xAxisInfo, textX, textY+h+font->getLineHeight()-config->info_margin+config->titleTextSpacer );
+
+    }else{
+        ofDrawBitmapString( plotTitle, textX, textY );
     }
 
     return true;
@@ -19,9 +19,14 @@
  */
 #pragma once
 
+#include <limits>
 #include <GRT/GRT.h>
 #include "ofMain.h"
 #include "ofxGrtSettings.h"
+#include "ofxGrtTextCache.h"
+#include "ofxGrtSampleBuffer.h"
+#include "ofxGrtPixelUploader.h"
+#include "ofxGrtMatrixTiles.h"
 
 using namespace GRT;
 
@@ -30,6 +35,8 @@ using namespace GRT;
 */
 class ofxGrtMatrixPlot {
 public:
+    static const unsigned int DEFAULT_TILE_SIZE = 512; ///< The tile size used for matrices larger than GL_MAX_TEXTURE_SIZE if no tile size is set
+
     /**
     Default constructor, sets the size, name, and font of the matrix to be drawn. These can all be changed later using the various setter functions.
     @param rows: the number of rows in the matrix
@@ -75,6 +82,25 @@ public:
     */
     bool update( const MatrixFloat &data, const float minValue, const float maxValue );
 
+    /**
+    Updates the internal data with the matrix scaled so its min value is 0 and its max value is 1. The matrix is read once (finding its range while it is copied) and then
+    scaled with SSE2/NEON, so this is faster than calling getMinValue(), getMaxValue() and then update( data, minValue, maxValue ).
+    @param data: the input data that should be drawn
+    @return returns true if the instance was updated successfully, false otherwise
+    */
+    bool updateNormalized( const MatrixFloat &data );
+
+    /**
+    Updates the internal data with the matrix scaled so its min value is 0 and its max value is 1, NaN values are ignored when finding the range.
+    @param data: a pointer to the first row of the matrix
+    @param rows: the number of rows in the matrix
+    @param cols: the number of columns in the matrix
+    @param rowStride: the distance between the start of each row, in elements, this lets a sub matrix or padded rows be drawn without copying. 0 means the rows are packed (cols)
+    @return returns true if the instance was updated successfully, false otherwise
+    */
+    bool updateNormalized( const float *data, const unsigned int rows, const unsigned int cols, const unsigned int rowStride = 0 );
+    bool updateNormalized( const double *data, const unsigned int rows, const unsigned int cols, const unsigned int rowStride = 0 );
+
     /**
     Updates the internal data to prepare it for drawing, the data in the input matrix should be scaled in the range [0. 1.].
     If the size of the rows and cols does not match that of the internal buffers then the internal buffers will be automatically rescaled to match.
@@ -85,6 +111,65 @@ public:
     */
     bool update( float *data, const unsigned int rows, const unsigned int cols );
 
+    /**
+    Updates the instance with the full matrix, but only uploads the cells in the region to the texture. This should be used when the caller knows which cells changed
+    (e.g. the band of a DTW cost matrix computed for the latest sample). If the size of the matrix has changed the whole matrix is uploaded.
+    The Matrix update overloads find the changed region themselves, by comparing the new matrix with the last one.
+    @param data: a pointer to the full matrix, stored row by row, it should be normalized to [0. 1.]
+    @param rows: the number of rows in the matrix
+    @param cols: the number of columns in the matrix
+    @param firstRow: the first row of the region that changed
+    @param firstCol: the first column of the region that changed
+    @param numRows: the number of rows in the region
+    @param numCols: the number of columns in the region
+    @return returns true if the instance was updated successfully, false otherwise
+    */
+    bool update( float *data, const unsigned int rows, const unsigned int cols, const unsigned int firstRow, const unsigned int firstCol, const unsigned int numRows, const unsigned int numCols );
+
+    /**
+    Binds the plot to a float matrix owned by the caller, the matrix is uploaded straight from this memory (without being copied into the plot) now and whenever markDirty is called.
+    This is the cheapest way to draw a matrix that is already stored row by row as floats normalized to [0. 1.]. The memory must stay valid until unbindBuffer is called or
+    another buffer is bound. The compact sample formats still quantize the matrix into the plot, as do tiled matrices, which copy it so their tiles can be uploaded as they are drawn.
+    The other update functions can still be called, markDirty then uploads the bound buffer again.
+    @param data: a pointer to the first row of the matrix
+    @param rows: the number of rows in the matrix
+    @param cols: the number of columns in the matrix
+    @param rowStride: the distance between the start of each row, in floats, 0 means the rows are packed (cols)
+    @return returns true if the buffer was bound and uploaded successfully, false otherwise
+    */
+    bool bindBuffer( const float *data, const unsigned int rows, const unsigned int cols, const unsigned int rowStride = 0 );
+
+    /**
+    @brief releases the buffer bound by bindBuffer, the texture keeps the last values that were uploaded
+    @return returns true if the buffer was released successfully, false otherwise
+    */
+    bool unbindBuffer();
+
+    /**
+    @brief uploads the whole bound buffer again, this should be called after the caller changes the buffer
+    @return returns true if the buffer was uploaded successfully, false if no buffer is bound
+    */
+    bool markDirty();
+
+    /**
+    @brief uploads a region of the bound buffer again, this should be called after the caller changes the cells in the region
+    @param firstRow: the first row of the region that changed
+    @param firstCol: the first column of the region that changed
+    @param numRows: the number of rows in the region
+    @param numCols: the number of columns in the region
+    @return returns true if the region was uploaded successfully, false if no buffer is bound or the region is outside the buffer
+    */
+    bool markDirty( const unsigned int firstRow, const unsigned int firstCol, const unsigned int numRows, const unsigned int numCols );
+
+    /**
+    Writes a single column into the matrix texture, replacing the oldest column, so a scrolling plot (e.g. a spectrogram) only uploads one column per hop rather than the whole matrix.
+    The columns are kept in a ring in the texture and the draw functions apply the ring offset through the texture coordinates, so the oldest column is always drawn on the left.
+    The matrix must have been sized by resize (or a previous update) first, and this must be called from the thread that owns the GL context.
+    @param column: the rows values of the new column, normalized to [0. 1.], column[0] is the top row
+    @return returns true if the column was written successfully, false otherwise
+    */
+    bool pushColumn( const float *column );
+
     /**
     Draws the current data in the internal buffer at the location [x,y] on the screen. The data will be draw with a width and height matching the size of the matrix.
     @param x: the x location to draw the matrix
@@ -137,6 +222,71 @@ public:
     */
     bool setTitle( const std::string &plotTitle );
 
+    /**
+    @brief sets the texel format used to store the matrix on the GPU. The matrix data is normalized to [0. 1.], so OFXGRT_SAMPLE_UINT8 (8-bit) and OFXGRT_SAMPLE_INT16
+    (16-bit, normalized) store it with no visible loss in 1/4 and 1/2 of the memory and upload bandwidth of a float texture. OFXGRT_SAMPLE_HALF stores a 16-bit float texture.
+    The texture is reallocated on the next update.
+    @param format: the texel format
+    @return returns true if the format was set successfully, false otherwise
+    */
+    bool setSampleFormat( const ofxGrtSampleFormat format );
+
+    /**
+    @return returns the texel format used to store the matrix on the GPU
+    */
+    ofxGrtSampleFormat getSampleFormat() const;
+
+    /**
+    @brief sets if full matrix updates are uploaded asynchronously through two pixel buffer objects. The update then only copies the matrix into a pixel buffer and
+    queues the transfer, so generating the next matrix overlaps with the transfer of the last one rather than the update waiting for the driver to copy it.
+    This is worth enabling for large matrices that change every frame, the partial updates of small regions and pushColumn are still uploaded directly.
+    @param enabled: true if full updates should be uploaded asynchronously
+    @return returns true if the parameter was updated successfully, false otherwise
+    */
+    bool setAsyncUpload( const bool enabled );
+
+    /**
+    @return returns true if full matrix updates are uploaded asynchronously, false otherwise
+    */
+    bool getAsyncUpload() const;
+
+    /**
+    @brief sets the size of the tiles used to draw large matrices. If the size is above 0, the matrix is split into tiles of this size with a pyramid of downsampled levels,
+    and only the tiles of the level that matches the screen resolution that are inside the viewport are uploaded and drawn (see ofxGrtMatrixTiles). If the size is 0 (the default)
+    a single texture is used, unless the matrix is larger than GL_MAX_TEXTURE_SIZE, then tiles of DEFAULT_TILE_SIZE are used. The new size is used from the next update.
+    When tiled, the pyramid is rebuilt on each full update and pushColumn is not supported, so the tiles are best suited to large matrices that change rarely or in small regions.
+    @param tileSize: the width and height of each tile, or 0 to only use tiles when the matrix does not fit in a texture
+    @return returns true if the parameter was updated successfully, false otherwise
+    */
+    bool setTileSize( const unsigned int tileSize );
+
+    /**
+    @return returns true if the matrix is currently drawn from tiles, false if it is drawn from a single texture
+    */
+    bool getIsTiled() const;
+
+    /**
+    @brief sets the part of the matrix that is drawn when the matrix is tiled, this is used to zoom in and pan around large matrices. The viewport is given in matrix cells
+    and can be fractional, the part of the viewport outside the matrix is left empty.
+    @param firstRow: the row at the top of the viewport
+    @param firstCol: the column at the left of the viewport
+    @param numRows: the number of rows in the viewport
+    @param numCols: the number of columns in the viewport
+    @return returns true if the viewport was set successfully, false otherwise
+    */
+    bool setViewport( const float firstRow, const float firstCol, const float numRows, const float numCols );
+
+    /**
+    @brief resets the viewport so the whole matrix is drawn
+    @return returns true if the viewport was reset successfully, false otherwise
+    */
+    bool resetViewport();
+
+    /**
+    @return returns a reference to the tiles, which can be used to change their cache limits
+    */
+    ofxGrtMatrixTiles& getTiles();
+
     /**
     @return returns the number of rows in the matrix
     */
@@ -157,6 +307,40 @@ public:
     */
     unsigned int getHeight() const;
 protected:
+    bool drawText(const float x, const float y, const float w, const float h) const;
+    /**
+    @brief the bounding box of the cells that changed since the last upload, the bounds are inclusive
+    */
+    struct Region{
+        unsigned int firstRow, firstCol, lastRow, lastCol;
+        void clear(){
+            firstRow = firstCol = std::numeric_limits< unsigned int >::max();
+            lastRow = lastCol = 0;
+        }
+        bool isEmpty() const { return firstRow > lastRow; }
+        void add( const unsigned int row, const unsigned int col ){
+            if( row < firstRow ) firstRow = row;
+            if( row > lastRow ) lastRow = row;
+            if( col < firstCol ) firstCol = col;
+            if( col > lastCol ) lastCol = col;
+        }
+    };
+
+    template< class MatrixType > bool updateMatrix( const MatrixType &data, const float minValue, const float maxValue );
+    template< class T > bool updateNormalizedRows( const T *data, const unsigned int rows, const unsigned int cols, const unsigned int rowStride );
+    bool updateScaled( const float *data, const unsigned int rows, const unsigned int cols, const float minValue, const float maxValue );
+    bool finishUpdate( const bool partial, const unsigned int rows, const unsigned int cols );
+    template< class T > void packRow( const T *row, const size_t offset, const unsigned int count, const float minValue, const float maxValue, Region *dirty = NULL, const unsigned int rowIndex = 0 );
+    bool uploadPacked( const unsigned int rows, const unsigned int cols );
+    bool uploadRegion( const void *data, const Region &region, const unsigned int rowLength = 0 );
+    bool uploadBound( const Region *region );
+    bool uploadFull( const void *data, const unsigned int rows, const unsigned int cols );
+    GLenum getGlType() const;
+    bool canUpdateRegion( const unsigned int rows, const unsigned int cols ) const;
+    bool useTiles( const unsigned int rows, const unsigned int cols ) const;
+    void drawTexture( const float x, const float y, const float w, const float h ) const;
+    bool allocateTexture( const unsigned int rows, const unsigned int cols );
+
     unsigned int rows;
     unsigned int cols;
 
@@ -165,9 +349,27 @@ protected:
     std::string yAxisInfo;
     ofColor textColor;
     vector<float> pixelData;
+    vector<float> normalizeScratch; ///< The matrix copied into packed rows by updateNormalized, before it is scaled into pixelData
     ofFloatPixels pixels;
     ofTexture texture;
+    unsigned int scrollOffset; ///< The texture column that holds the oldest column pushed by pushColumn, this is 0 after a full update
+    bool bufferUploaded; ///< True if the texture holds exactly the pixelData (or packedData for the compact formats), so the next matrix update can upload just the cells that changed
+    Region dirtyRegion;
+    ofxGrtSampleFormat sampleFormat;
+    ofxGrtSampleFormat textureFormat; ///< The format the texture was allocated with, the texture is reallocated when this or its size changes
+    vector< unsigned char > packedData; ///< The matrix quantized to the sample format, used instead of pixelData when the format is not float
+    bool asyncUpload;
+    bool tiled;
+    unsigned int tileSize;
+    float viewRow, viewCol, viewRows, viewCols; ///< The viewport used when the matrix is tiled, in matrix cells, viewRows and viewCols are 0 if the whole matrix is drawn
+    const float *boundData; ///< The caller's matrix set by bindBuffer, or NULL if no buffer is bound
+    unsigned int boundRows;
+    unsigned int boundCols;
+    unsigned int boundStride;
+    mutable ofxGrtMatrixTiles tiles; ///< Tiles are uploaded as they come into view, draw is const so the tiles are mutable
+    ofxGrtPixelUploader uploader;
     const ofTrueTypeFont *font;
+    mutable ofxGrtTextCache textCache; ///< Glyph meshes for the title and axis text, draw is const so the cache is mutable
     
     std::shared_ptr<ofxGrtSettings::variables> config;
 };
@@ -0,0 +1,278 @@
+#include "ofxGrtMatrixTiles.h"
+
+ofxGrtMatrixTiles::ofxGrtMatrixTiles(){
+    levelZero = NULL;
+    rows = cols = 0;
+    tileSize = 0;
+    format = OFXGRT_SAMPLE_FLOAT;
+    maxResidentTiles = 128;
+    maxUploadsPerFrame = 8;
+    uploadsThisFrame = 0;
+    currentFrame = 0;
+}
+
+ofxGrtMatrixTiles::~ofxGrtMatrixTiles(){
+}
+
+bool ofxGrtMatrixTiles::setup( const void *data, const unsigned int rows, const unsigned int cols, const ofxGrtSampleFormat format, const unsigned int tileSize ){
+
+    if( data == NULL || rows == 0 || cols == 0 || tileSize == 0 ) return false;
+
+    //Tiles can only be refreshed in place if the tile grid and texture format are unchanged
+    if( rows != this->rows || cols != this->cols || format != this->format || tileSize != this->tileSize ){
+        tiles.clear();
+    }
+
+    levelZero = static_cast< const unsigned char* >( data );
+    this->rows = rows;
+    this->cols = cols;
+    this->format = format;
+    this->tileSize = tileSize;
+
+    //Each level halves the one below it (rounding up) until the whole matrix fits in a single tile
+    levels.resize( 1 );
+    levels[0].rows = rows;
+    levels[0].cols = cols;
+    levels[0].data.clear();
+    const size_t texelSize = ofxGrtGetSampleSize( format );
+    while( levels.back().rows > tileSize || levels.back().cols > tileSize ){
+        Level level;
+        level.rows = (levels.back().rows + 1) / 2;
+        level.cols = (levels.back().cols + 1) / 2;
+        level.data.resize( (size_t)level.rows * level.cols * texelSize );
+        levels.push_back( level );
+        downsample( (unsigned int)levels.size()-1, 0, 0, level.rows-1, level.cols-1 );
+    }
+
+    for(std::map< uint64_t, Tile >::iterator iter = tiles.begin(); iter != tiles.end(); ++iter){
+        iter->second.stale = true;
+    }
+
+    return true;
+}
+
+bool ofxGrtMatrixTiles::update( const unsigned int firstRow, const unsigned int firstCol, const unsigned int lastRow, const unsigned int lastCol ){
+
+    if( !getIsSetup() || firstRow > lastRow || firstCol > lastCol || lastRow >= rows || lastCol >= cols ) return false;
+
+    //A cell at one level is built from the 2x2 cells below it, so the region halves at each level
+    unsigned int r0 = firstRow, c0 = firstCol, r1 = lastRow, c1 = lastCol;
+    markStale( 0, r0, c0, r1, c1 );
+    for(unsigned int level=1; level<levels.size(); level++){
+        r0 /= 2; c0 /= 2; r1 /= 2; c1 /= 2;
+        downsample( level, r0, c0, r1, c1 );
+        markStale( level, r0, c0, r1, c1 );
+    }
+
+    return true;
+}
+
+void ofxGrtMatrixTiles::draw( const float x, const float y, const float w, const float h, const float viewRow, const float viewCol, const float viewRows, const float viewCols ){
+
+    if( !getIsSetup() || w <= 0 || h <= 0 || viewRows <= 0 || viewCols <= 0 ) return;
+
+    const uint64_t frame = ofGetFrameNum();
+    if( frame != currentFrame ){
+        currentFrame = frame;
+        uploadsThisFrame = 0;
+    }
+
+    //Pick the finest level that still has at least one texel per screen pixel, along the axis that is zoomed in the most
+    const float texelsPerPixel = std::min( viewCols / w, viewRows / h );
+    unsigned int level = 0;
+    while( level+1 < levels.size() && (float)(2u << level) <= texelsPerPixel ) level++;
+
+    //The coarsest level is a single tile, it is always drawn so any tile of the chosen level that is not uploaded yet still shows the matrix
+    const unsigned int coarsest = (unsigned int)levels.size()-1;
+    drawLevel( coarsest, x, y, w, h, viewRow, viewCol, viewRows, viewCols, true );
+    if( level < coarsest ) drawLevel( level, x, y, w, h, viewRow, viewCol, viewRows, viewCols, false );
+
+    evictTiles();
+}
+
+void ofxGrtMatrixTiles::clear(){
+    levelZero = NULL;
+    rows = cols = 0;
+    levels.clear();
+    tiles.clear();
+    tileScratch.clear();
+}
+
+void ofxGrtMatrixTiles::setCacheLimits( const unsigned int maxResidentTiles, const unsigned int maxUploadsPerFrame ){
+    this->maxResidentTiles = maxResidentTiles;
+    this->maxUploadsPerFrame = maxUploadsPerFrame;
+}
+
+GLenum ofxGrtMatrixTiles::getGlType( const ofxGrtSampleFormat format ){
+    switch( format ){
+        case OFXGRT_SAMPLE_UINT8: return GL_UNSIGNED_BYTE;
+        case OFXGRT_SAMPLE_INT16: return GL_UNSIGNED_SHORT;
+        case OFXGRT_SAMPLE_HALF: return GL_HALF_FLOAT;
+        default: return GL_FLOAT;
+    }
+}
+
+GLint ofxGrtMatrixTiles::getGlInternalFormat( const ofxGrtSampleFormat format ){
+    switch( format ){
+        case OFXGRT_SAMPLE_UINT8: return GL_R8;
+        case OFXGRT_SAMPLE_INT16: return GL_R16;
+        case OFXGRT_SAMPLE_HALF: return GL_R16F;
+        default: return GL_R32F;
+    }
+}
+
+const unsigned char* ofxGrtMatrixTiles::getLevelData( const unsigned int level ) const{
+    return level == 0 ? levelZero : &levels[ level ].data[0];
+}
+
+void ofxGrtMatrixTiles::downsample( const unsigned int level, const unsigned int firstRow, const unsigned int firstCol, const unsigned int lastRow, const unsigned int lastCol ){
+
+    const Level &source = levels[ level-1 ];
+    const unsigned char *sourceData = getLevelData( level-1 );
+    Level &dest = levels[ level ];
+
+    //Each cell is the mean of the (up to) 2x2 cells below it, the last row and column of an odd sized level only have one cell below them
+    for(unsigned int i=firstRow; i<=lastRow; i++){
+        const unsigned int r = i*2;
+        const unsigned int numRows = r+1 < source.rows ? 2 : 1;
+        for(unsigned int j=firstCol; j<=lastCol; j++){
+            const unsigned int c = j*2;
+            const unsigned int numCols = c+1 < source.cols ? 2 : 1;
+            float sum = 0;
+            for(unsigned int n=0; n<numRows; n++){
+                const size_t index = (size_t)(r+n)*source.cols + c;
+                sum += decode( sourceData, index );
+                if( numCols == 2 ) sum += decode( sourceData, index+1 );
+            }
+            encode( &dest.data[0], (size_t)i*dest.cols + j, sum / (numRows*numCols) );
+        }
+    }
+}
+
+void ofxGrtMatrixTiles::markStale( const unsigned int level, const unsigned int firstRow, const unsigned int firstCol, const unsigned int lastRow, const unsigned int lastCol ){
+    for(unsigned int i=firstRow/tileSize; i<=lastRow/tileSize; i++){
+        for(unsigned int j=firstCol/tileSize; j<=lastCol/tileSize; j++){
+            std::map< uint64_t, Tile >::iterator iter = tiles.find( getKey( level, i, j ) );
+            if( iter != tiles.end() ) iter->second.stale = true;
+        }
+    }
+}
+
+void ofxGrtMatrixTiles::drawLevel( const unsigned int level, const float x, const float y, const float w, const float h, const float viewRow, const float viewCol, const float viewRows, const float viewCols, const bool force ){
+
+    const Level &L = levels[ level ];
+    const float factor = (float)(1u << level);
+
+    //The view in the cells of this level, clipped to the matrix. The last cell of a level can extend past the matrix, so only the part of it inside the matrix is drawn
+    const float levelRow = viewRow / factor;
+    const float levelCol = viewCol / factor;
+    const float r0 = std::max( levelRow, 0.0f );
+    const float c0 = std::max( levelCol, 0.0f );
+    const float r1 = std::min( viewRow + viewRows, (float)rows ) / factor;
+    const float c1 = std::min( viewCol + viewCols, (float)cols ) / factor;
+    if( r1 <= r0 || c1 <= c0 ) return;
+
+    const float scaleX = w / viewCols * factor;
+    const float scaleY = h / viewRows * factor;
+    const unsigned int numTileRows = (L.rows + tileSize - 1) / tileSize;
+    const unsigned int numTileCols = (L.cols + tileSize - 1) / tileSize;
+    const unsigned int lastTileRow = std::min( (unsigned int)std::ceil( r1 / tileSize ), numTileRows );
+    const unsigned int lastTileCol = std::min( (unsigned int)std::ceil( c1 / tileSize ), numTileCols );
+
+    for(unsigned int i=(unsigned int)(r0 / tileSize); i<lastTileRow; i++){
+        for(unsigned int j=(unsigned int)(c0 / tileSize); j<lastTileCol; j++){
+            Tile *tile = getTile( level, i, j, force );
+            if( tile == NULL ) continue;
+
+            //Only the part of the tile inside the view is drawn
+            const float tileRow = (float)(i*tileSize);
+            const float tileCol = (float)(j*tileSize);
+            const float sr0 = std::max( r0, tileRow );
+            const float sc0 = std::max( c0, tileCol );
+            const float sr1 = std::min( r1, tileRow + tile->texture.getHeight() );
+            const float sc1 = std::min( c1, tileCol + tile->texture.getWidth() );
+            if( sr1 <= sr0 || sc1 <= sc0 ) continue;
+
+            tile->texture.drawSubsection( x + (sc0 - levelCol) * scaleX, y + (sr0 - levelRow) * scaleY, (sc1 - sc0) * scaleX, (sr1 - sr0) * scaleY, sc0 - tileCol, sr0 - tileRow, sc1 - sc0, sr1 - sr0 );
+        }
+    }
+}
+
+ofxGrtMatrixTiles::Tile* ofxGrtMatrixTiles::getTile( const unsigned int level, const unsigned int tileRow, const unsigned int tileCol, const bool force ){
+
+    const uint64_t key = getKey( level, tileRow, tileCol );
+    std::map< uint64_t, Tile >::iterator iter = tiles.find( key );
+    if( iter != tiles.end() ){
+        iter->second.lastUsedFrame = currentFrame;
+        if( !iter->second.stale ) return &iter->second;
+    }
+
+    //Uploads are limited per frame so panning over a large matrix does not stall, a stale tile is drawn as it is until it can be refreshed
+    if( !force && uploadsThisFrame >= maxUploadsPerFrame ){
+        return iter != tiles.end() ? &iter->second : NULL;
+    }
+
+    const Level &L = levels[ level ];
+    const unsigned int firstRow = tileRow * tileSize;
+    const unsigned int firstCol = tileCol * tileSize;
+    const unsigned int tileRows = std::min( tileSize, L.rows - firstRow );
+    const unsigned int tileCols = std::min( tileSize, L.cols - firstCol );
+
+    //Copy the rows of the tile out of the level so they are packed for the upload
+    const size_t texelSize = ofxGrtGetSampleSize( format );
+    const size_t rowSize = tileCols * texelSize;
+    const unsigned char *levelData = getLevelData( level );
+    tileScratch.resize( tileRows * rowSize );
+    for(unsigned int i=0; i<tileRows; i++){
+        memcpy( &tileScratch[ i*rowSize ], levelData + ((size_t)(firstRow + i)*L.cols + firstCol) * texelSize, rowSize );
+    }
+
+    Tile &tile = tiles[ key ];
+    if( !tile.texture.isAllocated() || tile.texture.getWidth() != tileCols || tile.texture.getHeight() != tileRows ){
+        tile.texture.allocate( tileCols, tileRows, getGlInternalFormat( format ) );
+        tile.texture.setRGToRGBASwizzles(true);
+        tile.texture.setTextureMinMagFilter( GL_LINEAR, GL_LINEAR );
+        tile.texture.setTextureWrap( GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE );
+    }
+    tile.texture.loadData( (const void*)&tileScratch[0], tileCols, tileRows, GL_RED, getGlType( format ) );
+    tile.lastUsedFrame = currentFrame;
+    tile.stale = false;
+    uploadsThisFrame++;
+
+    return &tile;
+}
+
+void ofxGrtMatrixTiles::evictTiles(){
+
+    //Evict the least recently drawn tiles, but never a tile that was drawn this frame
+    while( tiles.size() > maxResidentTiles ){
+        std::map< uint64_t, Tile >::iterator oldest = tiles.end();
+        for(std::map< uint64_t, Tile >::iterator iter = tiles.begin(); iter != tiles.end(); ++iter){
+            if( iter->second.lastUsedFrame < currentFrame && (oldest == tiles.end() || iter->second.lastUsedFrame < oldest->second.lastUsedFrame) ){
+                oldest = iter;
+            }
+        }
+        if( oldest == tiles.end() ) return;
+        tiles.erase( oldest );
+    }
+}
+
+float ofxGrtMatrixTiles::decode( const unsigned char *data, const size_t index ) const{
+    switch( format ){
+        case OFXGRT_SAMPLE_UINT8: return data[ index ] / 255.0f;
+        case OFXGRT_SAMPLE_INT16: return reinterpret_cast< const unsigned short* >( data )[ index ] / 65535.0f;
+        case OFXGRT_SAMPLE_HALF: return ofxGrtHalfToFloat( reinterpret_cast< const unsigned short* >( data )[ index ] );
+        default: return reinterpret_cast< const float* >( data )[ index ];
+    }
+}
+
+void ofxGrtMatrixTiles::encode( unsigned char *data, const size_t index, const float value ) const{
+    //The normalized formats are clamped and rounded the same way ofxGrtMatrixPlot quantizes them
+    const float v = value >= 0.0f ? (value <= 1.0f ? value : 1.0f) : 0.0f;
+    switch( format ){
+        case OFXGRT_SAMPLE_UINT8: data[ index ] = (unsigned char)( v * 255.0f + 0.5f ); break;
+        case OFXGRT_SAMPLE_INT16: reinterpret_cast< unsigned short* >( data )[ index ] = (unsigned short)( v * 65535.0f + 0.5f ); break;
+        case OFXGRT_SAMPLE_HALF: reinterpret_cast< unsigned short* >( data )[ index ] = ofxGrtFloatToHalf( value ); break;
+        default: reinterpret_cast< float* >( data )[ index ] = value; break;
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include "ofMain.h"
+#include "ofxGrtSampleBuffer.h"
+#include <map>
+
+/**
+ @brief Draws a matrix that is too large for a single texture (or too large to upload every frame) from square tiles. A pyramid of downsampled levels is kept
+ on the CPU, each level half the size of the one below it, and only the tiles of the level that best matches the screen resolution that intersect the
+ view are uploaded and drawn. The coarsest level always fits in one tile and is drawn under the view, so tiles that have not been uploaded yet show the
+ coarse matrix instead of a gap. Uploaded tiles are kept in a cache that evicts the least recently drawn tiles once it is full.
+ The data of level 0 is not copied, the pointer passed to setup must stay valid (and hold the matrix) until the next call to setup or clear.
+*/
+class ofxGrtMatrixTiles{
+public:
+    ofxGrtMatrixTiles();
+    ~ofxGrtMatrixTiles();
+
+    /**
+     @brief builds the pyramid for the matrix, any uploaded tiles are kept and refreshed when they are next drawn
+     @param data: the matrix, stored row by row in the format, normalized to [0 1]
+     @param rows: the number of rows in the matrix
+     @param cols: the number of columns in the matrix
+     @param format: the format of the data, this is also the texture format of the tiles
+     @param tileSize: the width and height of each tile, in texels
+     @return returns true if the pyramid was built, false otherwise
+    */
+    bool setup( const void *data, const unsigned int rows, const unsigned int cols, const ofxGrtSampleFormat format, const unsigned int tileSize );
+
+    /**
+     @brief updates the pyramid after the cells [firstRow lastRow] x [firstCol lastCol] of the matrix changed, only the tiles that cover the cells are refreshed
+     @return returns true if the region was updated, false otherwise
+    */
+    bool update( const unsigned int firstRow, const unsigned int firstCol, const unsigned int lastRow, const unsigned int lastCol );
+
+    /**
+     @brief draws the part of the matrix inside the view to [x y w h], the view is given in matrix cells and can be fractional
+    */
+    void draw( const float x, const float y, const float w, const float h, const float viewRow, const float viewCol, const float viewRows, const float viewCols );
+
+    /**
+     @brief releases the pyramid and all the uploaded tiles
+    */
+    void clear();
+
+    /**
+     @brief sets the maximum number of tiles kept on the GPU and the maximum number of tiles uploaded in one frame
+    */
+    void setCacheLimits( const unsigned int maxResidentTiles, const unsigned int maxUploadsPerFrame );
+
+    bool getIsSetup() const { return rows > 0 && cols > 0; }
+    unsigned int getNumLevels() const { return (unsigned int)levels.size(); }
+    unsigned int getNumResidentTiles() const { return (unsigned int)tiles.size(); }
+
+    static GLenum getGlType( const ofxGrtSampleFormat format );
+    static GLint getGlInternalFormat( const ofxGrtSampleFormat format );
+
+protected:
+    struct Level{
+        unsigned int rows;
+        unsigned int cols;
+        std::vector< unsigned char > data; ///< Empty for level 0, which is read from the matrix passed to setup
+    };
+    struct Tile{
+        ofTexture texture;
+        uint64_t lastUsedFrame;
+        bool stale;
+    };
+
+    const unsigned char* getLevelData( const unsigned int level ) const;
+    void downsample( const unsigned int level, const unsigned int firstRow, const unsigned int firstCol, const unsigned int lastRow, const unsigned int lastCol );
+    void markStale( const unsigned int level, const unsigned int firstRow, const unsigned int firstCol, const unsigned int lastRow, const unsigned int lastCol );
+    void drawLevel( const unsigned int level, const float x, const float y, const float w, const float h, const float viewRow, const float viewCol, const float viewRows, const float viewCols, const bool force );
+    Tile* getTile( const unsigned int level, const unsigned int tileRow, const unsigned int tileCol, const bool force );
+    void evictTiles();
+    float decode( const unsigned char *data, const size_t index ) const;
+    void encode( unsigned char *data, const size_t index, const float value ) const;
+
+    static uint64_t getKey( const unsigned int level, const unsigned int tileRow, const unsigned int tileCol ){
+        return ((uint64_t)level << 48) | ((uint64_t)tileRow << 24) | (uint64_t)tileCol;
+    }
+
+    const unsigned char *levelZero;
+    unsigned int rows;
+    unsigned int cols;
+    unsigned int tileSize;
+    ofxGrtSampleFormat format;
+    std::vector< Level > levels;
+    std::map< uint64_t, Tile > tiles;
+    std::vector< unsigned char > tileScratch;
+    unsigned int maxResidentTiles;
+    unsigned int maxUploadsPerFrame;
+    unsigned int uploadsThisFrame;
+    uint64_t currentFrame;
+};
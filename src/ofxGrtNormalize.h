@@ -0,0 +1,171 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OFXGRT_NORMALIZE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OFXGRT_NORMALIZE_NEON
+#endif
+
+/**
+ @brief Vectorized kernels used to normalize matrices for display. SSE2 is used on x86 (it is always available on x86-64) and NEON on ARM,
+ anything else falls back to the scalar loops, which are also used for the last few values of each row.
+ NaN values are ignored by the min/max search, as they are by the scalar comparisons.
+*/
+
+/**
+ @brief copies count values from src to dest and updates minValue and maxValue with the range of the copied values
+*/
+inline void ofxGrtCopyRange( const float *src, float *dest, const unsigned int count, float &minValue, float &maxValue ){
+    unsigned int i = 0;
+#if defined(OFXGRT_NORMALIZE_SSE2)
+    if( count >= 4 ){
+        __m128 minV = _mm_set1_ps( minValue );
+        __m128 maxV = _mm_set1_ps( maxValue );
+        for(; i+4<=count; i+=4){
+            const __m128 v = _mm_loadu_ps( src + i );
+            _mm_storeu_ps( dest + i, v );
+            minV = _mm_min_ps( v, minV ); //If v is NaN the second operand is returned, so NaN never replaces the running min/max
+            maxV = _mm_max_ps( v, maxV );
+        }
+        float lanes[4];
+        _mm_storeu_ps( lanes, minV );
+        for(unsigned int k=0; k<4; k++) if( lanes[k] < minValue ) minValue = lanes[k];
+        _mm_storeu_ps( lanes, maxV );
+        for(unsigned int k=0; k<4; k++) if( lanes[k] > maxValue ) maxValue = lanes[k];
+    }
+#elif defined(OFXGRT_NORMALIZE_NEON)
+    if( count >= 4 ){
+        float32x4_t minV = vdupq_n_f32( minValue );
+        float32x4_t maxV = vdupq_n_f32( maxValue );
+        for(; i+4<=count; i+=4){
+            const float32x4_t v = vld1q_f32( src + i );
+            vst1q_f32( dest + i, v );
+            //vmin/vmax propagate NaN, so the lanes are selected with comparisons, which are false for NaN
+            minV = vbslq_f32( vcltq_f32( v, minV ), v, minV );
+            maxV = vbslq_f32( vcgtq_f32( v, maxV ), v, maxV );
+        }
+        float lanes[4];
+        vst1q_f32( lanes, minV );
+        for(unsigned int k=0; k<4; k++) if( lanes[k] < minValue ) minValue = lanes[k];
+        vst1q_f32( lanes, maxV );
+        for(unsigned int k=0; k<4; k++) if( lanes[k] > maxValue ) maxValue = lanes[k];
+    }
+#endif
+    for(; i<count; i++){
+        const float v = src[i];
+        dest[i] = v;
+        if( v < minValue ) minValue = v;
+        if( v > maxValue ) maxValue = v;
+    }
+}
+
+/**
+ @brief converts count doubles from src to floats in dest and updates minValue and maxValue with the range of the converted values
+*/
+inline void ofxGrtCopyRange( const double *src, float *dest, const unsigned int count, float &minValue, float &maxValue ){
+    unsigned int i = 0;
+#if defined(OFXGRT_NORMALIZE_SSE2)
+    if( count >= 4 ){
+        __m128 minV = _mm_set1_ps( minValue );
+        __m128 maxV = _mm_set1_ps( maxValue );
+        for(; i+4<=count; i+=4){
+            const __m128 v = _mm_movelh_ps( _mm_cvtpd_ps( _mm_loadu_pd( src + i ) ), _mm_cvtpd_ps( _mm_loadu_pd( src + i + 2 ) ) );
+            _mm_storeu_ps( dest + i, v );
+            minV = _mm_min_ps( v, minV );
+            maxV = _mm_max_ps( v, maxV );
+        }
+        float lanes[4];
+        _mm_storeu_ps( lanes, minV );
+        for(unsigned int k=0; k<4; k++) if( lanes[k] < minValue ) minValue = lanes[k];
+        _mm_storeu_ps( lanes, maxV );
+        for(unsigned int k=0; k<4; k++) if( lanes[k] > maxValue ) maxValue = lanes[k];
+    }
+#endif
+    for(; i<count; i++){
+        const float v = (float)src[i];
+        dest[i] = v;
+        if( v < minValue ) minValue = v;
+        if( v > maxValue ) maxValue = v;
+    }
+}
+
+/**
+ @brief writes (src[i] - minValue) * scale to dest. If track is true, firstChanged and lastChanged are set to the first and last index
+ where the new value differs from the value already in dest
+ @return returns true if track is true and any value changed, false otherwise
+*/
+inline bool ofxGrtScaleRange( const float *src, float *dest, const unsigned int count, const float minValue, const float scale, const bool track, unsigned int &firstChanged, unsigned int &lastChanged ){
+    bool changed = false;
+    unsigned int i = 0;
+#if defined(OFXGRT_NORMALIZE_SSE2)
+    const __m128 minV = _mm_set1_ps( minValue );
+    const __m128 scaleV = _mm_set1_ps( scale );
+    for(; i+4<=count; i+=4){
+        const __m128 v = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( src + i ), minV ), scaleV );
+        if( track ){
+            const int mask = _mm_movemask_ps( _mm_cmpneq_ps( v, _mm_loadu_ps( dest + i ) ) );
+            if( mask ){
+                unsigned int first = 0, last = 3;
+                while( !(mask & (1 << first)) ) first++;
+                while( !(mask & (1 << last)) ) last--;
+                if( !changed ) firstChanged = i + first;
+                lastChanged = i + last;
+                changed = true;
+            }
+        }
+        _mm_storeu_ps( dest + i, v );
+    }
+#elif defined(OFXGRT_NORMALIZE_NEON)
+    const float32x4_t minV = vdupq_n_f32( minValue );
+    const float32x4_t scaleV = vdupq_n_f32( scale );
+    for(; i+4<=count; i+=4){
+        const float32x4_t v = vmulq_f32( vsubq_f32( vld1q_f32( src + i ), minV ), scaleV );
+        if( track ){
+            //The scalar comparison is used for the lanes, NEON has no cheap movemask and rows rarely change everywhere
+            float lanes[4];
+            vst1q_f32( lanes, v );
+            for(unsigned int k=0; k<4; k++){
+                if( lanes[k] != dest[i+k] ){
+                    if( !changed ) firstChanged = i + k;
+                    lastChanged = i + k;
+                    changed = true;
+                }
+            }
+        }
+        vst1q_f32( dest + i, v );
+    }
+#endif
+    for(; i<count; i++){
+        const float v = (src[i] - minValue) * scale;
+        if( track && v != dest[i] ){
+            if( !changed ) firstChanged = i;
+            lastChanged = i;
+            changed = true;
+        }
+        dest[i] = v;
+    }
+    return changed;
+}
@@ -0,0 +1,88 @@
+#include "ofxGrtPixelUploader.h"
+
+ofxGrtPixelUploader::ofxGrtPixelUploader(){
+    bufferSizes[0] = bufferSizes[1] = 0;
+    writeIndex = 0;
+    mappedSize = 0;
+}
+
+ofxGrtPixelUploader::~ofxGrtPixelUploader(){
+}
+
+bool ofxGrtPixelUploader::upload( ofTexture &texture, const void *data, const unsigned int width, const unsigned int height, const int glFormat, const int glType, const size_t bytesPerPixel ){
+
+    if( data == NULL || width == 0 || height == 0 || !texture.isAllocated() ) return false;
+    if( texture.getWidth() != width || texture.getHeight() != height ) return false;
+
+    const size_t size = (size_t)width * height * bytesPerPixel;
+    void *dest = map( size );
+    if( dest == NULL ){
+#ifndef TARGET_OPENGLES
+        ofLogWarning("ofxGrtPixelUploader") << "upload(...) - Failed to map the pixel buffer, uploading directly";
+#endif
+        texture.loadData( data, width, height, glFormat, glType );
+        return true;
+    }
+    memcpy( dest, data, size );
+
+    return commit( texture, width, height, glFormat, glType, bytesPerPixel );
+}
+
+void* ofxGrtPixelUploader::map( const size_t size ){
+
+#ifndef TARGET_OPENGLES
+    if( mappedSize > 0 || size == 0 ) return NULL;
+
+    ofBufferObject &buffer = buffers[ writeIndex ];
+
+    //The buffers only grow, so a matrix that changes size back and forth does not reallocate them every upload
+    if( bufferSizes[ writeIndex ] < size ){
+        buffer.allocate( size, GL_STREAM_DRAW );
+        bufferSizes[ writeIndex ] = size;
+    }
+
+    //Invalidating the buffer lets the driver hand back fresh storage if the GPU is still reading the old contents, rather than blocking the map
+    void *dest = buffer.mapRange< unsigned char >( 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT );
+    if( dest != NULL ) mappedSize = size;
+    return dest;
+#else
+    return NULL;
+#endif
+}
+
+bool ofxGrtPixelUploader::commit( ofTexture &texture, const unsigned int width, const unsigned int height, const int glFormat, const int glType, const size_t bytesPerPixel ){
+
+#ifndef TARGET_OPENGLES
+    if( mappedSize == 0 ) return false;
+
+    //The buffer is always unmapped, even if the data can not be uploaded, so the next map can go ahead
+    ofBufferObject &buffer = buffers[ writeIndex ];
+    buffer.unmap();
+    const size_t size = (size_t)width * height * bytesPerPixel;
+    const bool valid = size > 0 && size <= mappedSize && texture.isAllocated() && texture.getWidth() == width && texture.getHeight() == height;
+    mappedSize = 0;
+    if( !valid ) return false;
+
+    //The texture reads from the bound pixel buffer, so this only queues the transfer and returns
+    texture.loadData( buffer, glFormat, glType );
+    writeIndex = 1 - writeIndex;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ofxGrtPixelUploader::clear(){
+    if( mappedSize > 0 ) buffers[ writeIndex ].unmap();
+    mappedSize = 0;
+    for(unsigned int i=0; i<2; i++){
+        buffers[i] = ofBufferObject();
+        bufferSizes[i] = 0;
+    }
+    writeIndex = 0;
+}
+
+size_t ofxGrtPixelUploader::getMemorySize() const{
+    return bufferSizes[0] + bufferSizes[1];
+}
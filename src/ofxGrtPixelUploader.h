@@ -0,0 +1,86 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include "ofMain.h"
+
+/**
+ @brief Uploads pixel data to a texture through two pixel buffer objects that are used in turn. The data is copied into one buffer and the texture
+ is updated from it, which only queues the transfer, so the copy into the other buffer on the next upload (and whatever generates those pixels)
+ overlaps with the GPU transfer instead of waiting for it. Writing into the buffer the GPU may still be reading is avoided by alternating buffers
+ and invalidating the buffer before it is mapped.
+ Producers that generate the pixels themselves can skip the copy altogether: map returns the next pixel buffer, the pixels are written straight
+ into it and commit queues the transfer to the texture.
+ On OpenGL ES, where the buffers can not be mapped, the data is uploaded directly to the texture (and map returns NULL).
+*/
+class ofxGrtPixelUploader{
+public:
+    ofxGrtPixelUploader();
+    ~ofxGrtPixelUploader();
+
+    /**
+     @brief uploads the data to the texture, the texture must already be allocated with the width and height of the data
+     @param texture: the texture that will be updated
+     @param data: the pixel data, stored row by row without any padding
+     @param width: the width of the data, in pixels
+     @param height: the height of the data, in pixels
+     @param glFormat: the format of the data (e.g. GL_RED, GL_RGBA)
+     @param glType: the type of the data (e.g. GL_FLOAT, GL_UNSIGNED_BYTE)
+     @param bytesPerPixel: the size of a single pixel, in bytes
+     @return returns true if the upload was queued, false otherwise
+    */
+    bool upload( ofTexture &texture, const void *data, const unsigned int width, const unsigned int height, const int glFormat, const int glType, const size_t bytesPerPixel );
+
+    /**
+     @brief maps the next pixel buffer so the pixels can be written straight into it, rather than into a separate array that upload then copies.
+     The buffer must be handed to the texture by commit before the next call to map or upload. The contents of the buffer are undefined, so every pixel must be written
+     @param size: the size of the pixel data that will be written, in bytes
+     @return returns a pointer to the mapped buffer, or NULL if the buffer could not be mapped (or on OpenGL ES), in which case the data should be uploaded with upload instead
+    */
+    void* map( const size_t size );
+
+    /**
+     @brief unmaps the buffer returned by map and uploads it to the texture, the texture must already be allocated with the width and height of the data
+     @param texture: the texture that will be updated
+     @param width: the width of the data, in pixels
+     @param height: the height of the data, in pixels
+     @param glFormat: the format of the data (e.g. GL_RED, GL_RGBA)
+     @param glType: the type of the data (e.g. GL_FLOAT, GL_UNSIGNED_BYTE)
+     @param bytesPerPixel: the size of a single pixel, in bytes
+     @return returns true if the upload was queued, false if no buffer is mapped or the data does not match the texture or the mapped size
+    */
+    bool commit( ofTexture &texture, const unsigned int width, const unsigned int height, const int glFormat, const int glType, const size_t bytesPerPixel );
+
+    /**
+     @brief releases the pixel buffers, they are reallocated by the next upload
+    */
+    void clear();
+
+    /**
+     @return returns the total size of the pixel buffers, in bytes
+    */
+    size_t getMemorySize() const;
+
+protected:
+    ofBufferObject buffers[2];
+    size_t bufferSizes[2];
+    unsigned int writeIndex;
+    size_t mappedSize; ///< The size of the buffer mapped by map, 0 if no buffer is mapped
+};
@@ -0,0 +1,278 @@
+#include "ofxGrtPlotGroup.h"
+#include <algorithm>
+#include <functional>
+
+ofxGrtPlotGroup::ofxGrtPlotGroup(){
+    config = ofxGrtSettings::GetInstance().get();
+    font = &config->fontSmall;
+    timeseriesLength = 0;
+    plotSpacing = config->info_margin;
+    drawTimeAxisEnabled = true;
+    lineMesh.setMode( OF_PRIMITIVE_LINES );
+    errorLog.setKey("[ERROR ofxGrtPlotGroup]");
+}
+
+ofxGrtPlotGroup::~ofxGrtPlotGroup(){
+    //Clear each plot's back pointer, so a plot destroyed later does not try to leave this group
+    std::unique_lock<std::mutex> lock( mtx );
+    PlotsLock plotsLock( *this );
+    for(size_t i=0; i<plots.size(); i++){
+        plots[i]->group = NULL;
+    }
+}
+
+bool ofxGrtPlotGroup::setup( const unsigned int timeseriesLength ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( timeseriesLength == 0 ){
+        errorLog << __GRT_LOG__ << " The timeseries length must be greater than zero!" << endl;
+        return false;
+    }
+
+    {
+        PlotsLock plotsLock( *this );
+        for(size_t i=0; i<plots.size(); i++){
+            plots[i]->group = NULL;
+        }
+    }
+    plots.clear();
+    lockOrder.clear();
+
+    this->timeseriesLength = timeseriesLength;
+
+    return true;
+}
+
+bool ofxGrtPlotGroup::addPlot( ofxGrtTimeseriesPlot *plot ){
+
+    if( plot == NULL ) return false;
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( std::find( plots.begin(), plots.end(), plot ) != plots.end() ) return true;
+
+    std::unique_lock<std::mutex> plotLock( plot->mtx );
+
+    if( plot->group != NULL ){
+        errorLog << __GRT_LOG__ << " The plot is already in another group!" << endl;
+        return false;
+    }
+
+    if( !plot->initialized || plot->timeseriesLength != timeseriesLength ){
+        errorLog << __GRT_LOG__ << " The plot must be setup with the same timeseries length as the group!" << endl;
+        return false;
+    }
+
+    if( plot->ingestGate.getIsOpen() ){
+        errorLog << __GRT_LOG__ << " The plot ingest queue must be disabled before the plot is added to a group!" << endl;
+        return false;
+    }
+
+    plot->group = this;
+    plots.push_back( plot );
+    lockOrder.insert( std::upper_bound( lockOrder.begin(), lockOrder.end(), plot, std::less< ofxGrtTimeseriesPlot* >() ), plot );
+
+    return true;
+}
+
+bool ofxGrtPlotGroup::removePlot( ofxGrtTimeseriesPlot *plot ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    vector< ofxGrtTimeseriesPlot* >::iterator iter = std::find( plots.begin(), plots.end(), plot );
+    if( iter == plots.end() ) return false;
+
+    {
+        std::unique_lock<std::mutex> plotLock( plot->mtx );
+        plot->group = NULL;
+    }
+    plots.erase( iter );
+    lockOrder.erase( std::find( lockOrder.begin(), lockOrder.end(), plot ) );
+
+    return true;
+}
+
+bool ofxGrtPlotGroup::update( const vector< vector<float> > &data, const bool highlight, const std::string &label ){
+    return pushSamples( ofGetElapsedTimeMillis(), data, highlight, label );
+}
+
+bool ofxGrtPlotGroup::update( const vector< vector<double> > &data, const bool highlight, const std::string &label ){
+    return pushSamples( ofGetElapsedTimeMillis(), data, highlight, label );
+}
+
+bool ofxGrtPlotGroup::update( const uint64_t timestamp, const vector< vector<float> > &data, const bool highlight, const std::string &label ){
+    return pushSamples( timestamp, data, highlight, label );
+}
+
+bool ofxGrtPlotGroup::update( const uint64_t timestamp, const vector< vector<double> > &data, const bool highlight, const std::string &label ){
+    return pushSamples( timestamp, data, highlight, label );
+}
+
+template< class T > bool ofxGrtPlotGroup::pushSamples( const uint64_t timestamp, const vector< vector<T> > &data, const bool highlight, const std::string &label ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( timeseriesLength == 0 ){
+        errorLog << __GRT_LOG__ << " The group has not been setup!" << endl;
+        return false;
+    }
+
+    PlotsLock plotsLock( *this );
+
+    if( data.size() != plots.size() ){
+        errorLog << __GRT_LOG__ << " The number of samples does not match the number of plots in the group!" << endl;
+        return false;
+    }
+
+    //Check every plot before any are written, so the plots are either all updated or none are
+    for(size_t i=0; i<plots.size(); i++){
+        const ofxGrtTimeseriesPlot *plot = plots[i];
+        if( !plot->initialized || plot->timeseriesLength != timeseriesLength || plot->ingestGate.getIsOpen() ){
+            errorLog << __GRT_LOG__ << " Plot " << i << " has been setup again or has enabled its ingest queue since it was added to the group!" << endl;
+            return false;
+        }
+        if( data[i].size() != plot->numChannels || data[i].empty() ){
+            errorLog << __GRT_LOG__ << " The size of sample " << i << " does not match the number of channels in its plot!" << endl;
+            return false;
+        }
+    }
+
+    for(size_t i=0; i<plots.size(); i++){
+        //The ingest queue is disabled, so the plot's producer scratch is free to hold the converted sample
+        vector< float > &sample = plots[i]->ingestScratch;
+        sample.assign( data[i].begin(), data[i].end() );
+        plots[i]->pushSample( &sample[0], highlight, label, timestamp );
+    }
+
+    return true;
+}
+
+bool ofxGrtPlotGroup::draw( const int x, const int y, const int w, const int h ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( plots.empty() ) return false;
+
+    PlotsLock plotsLock( *this );
+
+    const float lineHeight = font != NULL && font->isLoaded() ? font->getLineHeight() : 12;
+    const float axisHeight = drawTimeAxisEnabled ? lineHeight + config->titleTextSpacer : 0;
+    const float numPlots = (float)plots.size();
+    const float plotHeight = (h - axisHeight - plotSpacing*(numPlots-1)) / numPlots;
+    if( plotHeight <= 0 ) return false;
+
+    //Each plot draws its own chrome, highlights and text, but appends its live lines to the shared mesh
+    lineMesh.clear();
+    bool result = true;
+    float plotY = y;
+    for(size_t i=0; i<plots.size(); i++){
+        if( !plots[i]->drawPlot( x, (int)plotY, w, (int)plotHeight, &lineMesh ) ) result = false;
+        plotY += plotHeight + plotSpacing;
+    }
+
+    //The live lines of every plot are drawn with one call
+    if( lineMesh.getNumVertices() > 0 ){
+        ofPushStyle();
+        ofEnableAlphaBlending();
+        lineMesh.draw();
+        ofPopStyle();
+    }
+
+    if( drawTimeAxisEnabled ){
+        drawTimeAxis( x + config->info_margin, y + h - axisHeight, w - config->info_margin );
+    }
+
+    return result;
+}
+
+void ofxGrtPlotGroup::lockPlots(){
+    for(size_t i=0; i<lockOrder.size(); i++){
+        lockOrder[i]->mtx.lock();
+    }
+}
+
+void ofxGrtPlotGroup::unlockPlots(){
+    for(size_t i=lockOrder.size(); i>0; i--){
+        lockOrder[i-1]->mtx.unlock();
+    }
+}
+
+void ofxGrtPlotGroup::drawTimeAxis( const float x, const float y, const float w ){
+
+    const unsigned int numTicks = 4;
+    const float tickSize = 4;
+
+    ofSetColor( config->axisColor );
+    ofDrawLine( x, y, x+w, y );
+
+    //Every plot holds the same timestamps for the samples pushed by the group, so the axis reads the ring of the first plot
+    const ofxGrtTimeseriesPlot *plot = plots[0];
+    if( plot->timeseriesLength != timeseriesLength ) return;
+    const uint64_t newest = plot->timestampBuffer[ plot->getRingIndex( timeseriesLength-1 ) ];
+    ofSetColor( config->activeTextColor );
+    for(unsigned int t=0; t<=numTicks; t++){
+        //Ticks are placed on sample slots, matching the x position the plots use for that slot
+        const unsigned int index = (timeseriesLength-1) * t / numTicks;
+        const float tickX = x + w * index / (float)timeseriesLength;
+        ofDrawLine( tickX, y, tickX, y+tickSize );
+
+        //No sample has been written to this slot yet
+        if( index < timeseriesLength - plot->numTimestamps ) continue;
+
+        const uint64_t timestamp = plot->timestampBuffer[ plot->getRingIndex( index ) ];
+        const float age = newest > timestamp ? (newest - timestamp) / 1000.0f : 0.0f;
+        const std::string text = age > 0 ? "-" + ofToString( age, 2 ) + "s" : "0s";
+        if( font != NULL && font->isLoaded() ){
+            const ofRectangle bounds = textCache.getStringBoundingBox( font, text );
+            textCache.drawString( font, text, tickX - bounds.width*0.5, y + tickSize + bounds.height );
+        }else{
+            ofDrawBitmapString( text, tickX, y + tickSize + 12 );
+        }
+    }
+}
+
+bool ofxGrtPlotGroup::setPlotSpacing( const float plotSpacing ){
+    std::unique_lock<std::mutex> lock( mtx );
+    this->plotSpacing = plotSpacing;
+    return true;
+}
+
+bool ofxGrtPlotGroup::setDrawTimeAxis( const bool drawTimeAxis ){
+    std::unique_lock<std::mutex> lock( mtx );
+    this->drawTimeAxisEnabled = drawTimeAxis;
+    return true;
+}
+
+bool ofxGrtPlotGroup::setFont( const ofTrueTypeFont *font ){
+    std::unique_lock<std::mutex> lock( mtx );
+    this->font = font;
+    textCache.clear();
+    return font == NULL || font->isLoaded();
+}
+
+uint64_t ofxGrtPlotGroup::getTimestamp( const unsigned int index ) const{
+    std::unique_lock<std::mutex> lock( mtx );
+    if( plots.empty() || index >= timeseriesLength ) return 0;
+    const ofxGrtTimeseriesPlot *plot = plots[0];
+    std::unique_lock<std::mutex> plotLock( plot->mtx );
+    if( plot->timeseriesLength != timeseriesLength || index < timeseriesLength - plot->numTimestamps ) return 0;
+    return plot->timestampBuffer[ plot->getRingIndex( index ) ];
+}
+
+unsigned int ofxGrtPlotGroup::getNumSamples() const{
+    std::unique_lock<std::mutex> lock( mtx );
+    if( plots.empty() ) return 0;
+    std::unique_lock<std::mutex> plotLock( plots[0]->mtx );
+    return plots[0]->numTimestamps;
+}
+
+unsigned int ofxGrtPlotGroup::getNumPlots() const{
+    std::unique_lock<std::mutex> lock( mtx );
+    return (unsigned int)plots.size();
+}
+
+unsigned int ofxGrtPlotGroup::getTimeseriesLength() const{
+    std::unique_lock<std::mutex> lock( mtx );
+    return timeseriesLength;
+}
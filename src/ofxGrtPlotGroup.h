@@ -0,0 +1,156 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include "ofMain.h"
+#include "GRT/GRT.h"
+#include "ofxGrtSettings.h"
+#include "ofxGrtTimeseriesPlot.h"
+#include "ofxGrtTextCache.h"
+
+using namespace GRT;
+
+/**
+ @brief Groups timeseries plots that are fed by the same clock (e.g. the raw data, features and predictions of a pipeline).
+ Each update locks every plot (always in the same order, so two groups or threads can never deadlock) and appends one sample with the same timestamp
+ to each, so the plots always stay aligned, and draw stacks the plots above a shared time axis with the live lines of all the plots merged into one mesh and
+ one draw call. The group keeps no timestamps of its own, the time axis is read from the timestamp ring of the first plot.
+ The plots are owned by the caller, a plot that is destroyed removes itself from its group.
+*/
+class ofxGrtPlotGroup{
+public:
+    ofxGrtPlotGroup();
+    ~ofxGrtPlotGroup();
+
+    /**
+     @brief sets the length of the shared time axis, any plots in the group are removed
+     @param timeseriesLength: the timeseries length of the plots that will be added to the group
+     @return returns true if the group was setup successfully, false otherwise
+    */
+    bool setup( const unsigned int timeseriesLength );
+
+    /**
+     @brief adds a plot to the group. The plot must be setup with the same timeseries length as the group, must not use the ingest queue (group updates are
+     applied to all plots at once under their locks) and can only be in one group at a time.
+     @param plot: the plot to add, it removes itself from the group when it is destroyed
+     @return returns true if the plot was added successfully, false otherwise
+    */
+    bool addPlot( ofxGrtTimeseriesPlot *plot );
+
+    /**
+     @brief removes a plot from the group
+     @return returns true if the plot was removed, false if the plot is not in the group
+    */
+    bool removePlot( ofxGrtTimeseriesPlot *plot );
+
+    /**
+     @brief appends one sample to every plot in the group, timestamped with the current time (ofGetElapsedTimeMillis)
+     @param data: one sample per plot, in the order the plots were added, the size of each sample must match the number of channels in its plot
+     @param highlight: whether or not to highlight the new data points (default false)
+     @param label: the label associated with the new data points
+     @return returns true if the plots were updated successfully, false otherwise (in which case no plot is updated)
+    */
+    bool update( const vector< vector<float> > &data, const bool highlight = false, const std::string &label = "" );
+    bool update( const vector< vector<double> > &data, const bool highlight = false, const std::string &label = "" );
+
+    /**
+     @brief appends one sample to every plot in the group with the given timestamp, this should be used when the samples carry their own clock (e.g. OSC or sensor time)
+     @param timestamp: the time of the sample in milliseconds, this should not be less than the previous timestamp
+     @return returns true if the plots were updated successfully, false otherwise (in which case no plot is updated)
+    */
+    bool update( const uint64_t timestamp, const vector< vector<float> > &data, const bool highlight = false, const std::string &label = "" );
+    bool update( const uint64_t timestamp, const vector< vector<double> > &data, const bool highlight = false, const std::string &label = "" );
+
+    /**
+     @brief draws the plots stacked from top to bottom in the order they were added, with the shared time axis below the last plot
+     @return returns true if the plots were drawn successfully, false otherwise
+    */
+    bool draw( const int x, const int y, const int w, const int h );
+
+    /**
+     @brief sets the vertical space (in pixels) left between the plots
+     @return returns true if the parameter was updated successfully, false otherwise
+    */
+    bool setPlotSpacing( const float plotSpacing );
+
+    /**
+     @brief sets if the shared time axis is drawn below the plots
+     @return returns true if the parameter was updated successfully, false otherwise
+    */
+    bool setDrawTimeAxis( const bool drawTimeAxis );
+
+    /**
+     @brief sets the font used to draw the time axis labels
+     @return returns true if the font was set successfully, false otherwise
+    */
+    bool setFont( const ofTrueTypeFont *font );
+
+    /**
+     @brief returns the timestamp of a slot in the shared time axis (read from the first plot), the oldest slot is 0 and the newest is timeseriesLength-1
+     @return returns the timestamp (in milliseconds), or 0 if no timestamped sample has been written to the slot or the group has no plots
+    */
+    uint64_t getTimestamp( const unsigned int index ) const;
+
+    /**
+     @return returns the number of timestamped samples in the shared time axis (read from the first plot), this is at most the timeseries length
+    */
+    unsigned int getNumSamples() const;
+
+    unsigned int getNumPlots() const;
+    unsigned int getTimeseriesLength() const;
+
+protected:
+    /**
+     @brief checks the data, then pushes one sample into each plot under the group mutex
+    */
+    template< class T > bool pushSamples( const uint64_t timestamp, const vector< vector<T> > &data, const bool highlight, const std::string &label );
+
+    /**
+     @brief locks (or unlocks) the mutex of every plot in the group, in the order of lockOrder. The caller must hold the group mutex
+    */
+    void lockPlots();
+    void unlockPlots();
+
+    /**
+     @brief holds the plot mutexes for the lifetime of the scope
+    */
+    struct PlotsLock{
+        PlotsLock( ofxGrtPlotGroup &group ) : group( group ) { group.lockPlots(); }
+        ~PlotsLock(){ group.unlockPlots(); }
+        ofxGrtPlotGroup &group;
+    };
+
+    /**
+     @brief draws the ticks and labels of the shared time axis along [x,x+w] at y, from the timestamps of the first plot. The caller must hold the mutex and the plot mutexes
+    */
+    void drawTimeAxis( const float x, const float y, const float w );
+
+    mutable std::mutex mtx; ///< Guards the group, it is always locked before any of the plot mutexes
+    vector< ofxGrtTimeseriesPlot* > plots;
+    vector< ofxGrtTimeseriesPlot* > lockOrder; ///< The plots sorted by address, which is the order their mutexes are locked in
+    unsigned int timeseriesLength;
+    float plotSpacing;
+    bool drawTimeAxisEnabled;
+    ofMesh lineMesh; ///< The live lines of every plot in the group, rebuilt and drawn once per frame
+    const ofTrueTypeFont *font;
+    ofxGrtTextCache textCache;
+    ErrorLog errorLog;
+    std::shared_ptr<ofxGrtSettings::variables> config;
+};
@@ -0,0 +1,81 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <atomic>
+#include <thread>
+
+/**
+ @brief Guards a lock-free producer path (e.g. an ingest queue or snapshot buffer) so the owner can safely reallocate it.
+ A producer calls enter before it touches the shared buffer and leave once it is done. If enter returns false the gate is
+ closed and the producer should take its locked path instead. close stops new producers entering and then waits for the
+ producers that are already inside to leave, so once it returns the buffer can be reallocated and opened again.
+ enter and leave never block, so the producer stays wait-free. close only waits for the producers in flight, which run a
+ bounded number of steps, it must not be called while holding anything a producer inside the gate could wait on.
+*/
+class ofxGrtProducerGate{
+public:
+    ofxGrtProducerGate(){
+        opened = false;
+        numProducers = 0;
+    }
+
+    /**
+     @brief called by a producer before it uses the lock-free path
+     @return returns true if the gate is open, in which case leave must be called once the producer is done
+    */
+    bool enter(){
+        //The counter is raised before the flag is checked, so close either sees this producer or this producer sees the gate closed
+        numProducers.fetch_add( 1 );
+        if( opened.load() ) return true;
+        numProducers.fetch_sub( 1, std::memory_order_release );
+        return false;
+    }
+
+    /**
+     @brief called by a producer once it has finished with the lock-free path, this must only follow a successful call to enter
+    */
+    void leave(){
+        numProducers.fetch_sub( 1, std::memory_order_release );
+    }
+
+    /**
+     @brief opens the gate, this should be called once the shared buffer has been allocated
+    */
+    void open(){
+        opened.store( true );
+    }
+
+    /**
+     @brief closes the gate and waits until every producer that entered it has left
+    */
+    void close(){
+        opened.store( false );
+        while( numProducers.load() != 0 ){
+            std::this_thread::yield();
+        }
+    }
+
+    bool getIsOpen() const { return opened.load( std::memory_order_relaxed ); }
+
+protected:
+    std::atomic< bool > opened;
+    std::atomic< unsigned int > numProducers; ///< The number of producers currently inside the gate
+};
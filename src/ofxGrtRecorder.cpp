@@ -0,0 +1,252 @@
+#include "ofxGrtRecorder.h"
+#include "ofMain.h"
+#include <cstring>
+#include <algorithm>
+#ifdef TARGET_WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define GRT_RECORDER_VERSION 1
+#define GRT_RECORDER_MIN_CAPACITY 65536
+
+ofxGrtRecorder::ofxGrtRecorder(){
+    numChannels = 0;
+    numFrames = 0;
+    capacity = 0;
+    mappingSize = 0;
+    mapping = NULL;
+    growthFailed = false;
+#ifdef TARGET_WIN32
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = NULL;
+#else
+    fileHandle = -1;
+#endif
+    errorLog.setKey("[ERROR ofxGrtRecorder]");
+}
+
+ofxGrtRecorder::~ofxGrtRecorder(){
+    close();
+}
+
+bool ofxGrtRecorder::open( const std::string &filename, const unsigned int numChannels ){
+
+    close();
+
+    if( numChannels == 0 ) return false;
+
+    const std::string path = ofToDataPath( filename, true );
+    unsigned long long fileSize = 0;
+
+#ifdef TARGET_WIN32
+    fileHandle = CreateFileA( path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL );
+    if( fileHandle == INVALID_HANDLE_VALUE ){
+        errorLog << __GRT_LOG__ << " Failed to open " << path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if( !GetFileSizeEx( fileHandle, &size ) ){
+        close();
+        return false;
+    }
+    fileSize = (unsigned long long)size.QuadPart;
+#else
+    fileHandle = ::open( path.c_str(), O_RDWR | O_CREAT, 0644 );
+    if( fileHandle < 0 ){
+        errorLog << __GRT_LOG__ << " Failed to open " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if( fstat( fileHandle, &info ) != 0 ){
+        close();
+        return false;
+    }
+    fileSize = (unsigned long long)info.st_size;
+#endif
+
+    this->filename = filename;
+    this->numChannels = numChannels;
+    const size_t frameSize = sizeof(float) * numChannels;
+
+    if( fileSize >= sizeof( Header ) ){
+        //Reopen an existing recording, the frames are mapped back in rather than read
+        if( !map( fileSize ) ){
+            close();
+            return false;
+        }
+        const Header *header = reinterpret_cast< const Header* >( mapping );
+        if( std::memcmp( header->magic, "GRTR", 4 ) != 0 || header->version != GRT_RECORDER_VERSION || header->numChannels != numChannels ||
+            header->numFrames > (fileSize - sizeof( Header )) / frameSize ){
+            errorLog << __GRT_LOG__ << " " << filename << " is not a recording with " << numChannels << " channels!" << std::endl;
+            //Unmap first so close leaves the file as it was
+            unmap();
+            close();
+            return false;
+        }
+        numFrames = header->numFrames;
+        return true;
+    }
+
+    //Create a new recording
+    if( !map( sizeof( Header ) + frameSize * GRT_RECORDER_MIN_CAPACITY ) ){
+        close();
+        return false;
+    }
+    Header *header = reinterpret_cast< Header* >( mapping );
+    std::memcpy( header->magic, "GRTR", 4 );
+    header->version = GRT_RECORDER_VERSION;
+    header->numChannels = numChannels;
+    header->reserved = 0;
+    header->numFrames = 0;
+    numFrames = 0;
+
+    return true;
+}
+
+void ofxGrtRecorder::close(){
+
+    const unsigned long long fileSize = sizeof( Header ) + sizeof(float) * numChannels * numFrames;
+    const bool truncate = mapping != NULL;
+
+    unmap();
+
+#ifdef TARGET_WIN32
+    if( fileHandle != INVALID_HANDLE_VALUE ){
+        if( truncate ){
+            LARGE_INTEGER size;
+            size.QuadPart = (LONGLONG)fileSize;
+            SetFilePointerEx( fileHandle, size, NULL, FILE_BEGIN );
+            SetEndOfFile( fileHandle );
+        }
+        CloseHandle( fileHandle );
+        fileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if( fileHandle >= 0 ){
+        if( truncate && ftruncate( fileHandle, (off_t)fileSize ) != 0 ){
+            errorLog << __GRT_LOG__ << " Failed to truncate " << filename << std::endl;
+        }
+        ::close( fileHandle );
+        fileHandle = -1;
+    }
+#endif
+
+    numChannels = 0;
+    numFrames = 0;
+    capacity = 0;
+    growthFailed = false;
+}
+
+bool ofxGrtRecorder::write( const unsigned int channel, const float *source, const size_t stride, const size_t numFrames ){
+
+    if( mapping == NULL || channel >= numChannels ) return false;
+    if( !reserve( this->numFrames + numFrames ) ) return false;
+
+    float *dest = getFrames() + this->numFrames * numChannels + channel;
+    for(size_t i=0; i<numFrames; i++){
+        dest[ i*numChannels ] = source[ i*stride ];
+    }
+
+    return true;
+}
+
+void ofxGrtRecorder::advance( const size_t numFrames ){
+
+    if( mapping == NULL || this->numFrames + numFrames > capacity ) return;
+
+    this->numFrames += numFrames;
+    reinterpret_cast< Header* >( mapping )->numFrames = this->numFrames;
+}
+
+const float* ofxGrtRecorder::getFrame( const unsigned long long index ) const{
+    if( mapping == NULL || index >= numFrames ) return NULL;
+    return getFrames() + index * numChannels;
+}
+
+bool ofxGrtRecorder::reserveAhead(){
+
+    if( mapping == NULL ) return false;
+
+    //Grow once the recording is 75% full, so write should never have to remap
+    if( numFrames * 4 < capacity * 3 ) return true;
+
+    return grow( capacity * 2 );
+}
+
+bool ofxGrtRecorder::reserve( const unsigned long long capacity ){
+
+    if( capacity <= this->capacity ) return true;
+
+    //Only reached if reserveAhead was not called in time or the block is larger than the space left
+    unsigned long long newCapacity = std::max( this->capacity * 2, (unsigned long long)GRT_RECORDER_MIN_CAPACITY );
+    while( newCapacity < capacity ) newCapacity *= 2;
+
+    return grow( newCapacity );
+}
+
+bool ofxGrtRecorder::grow( const unsigned long long newCapacity ){
+
+    //map keeps the current mapping until the new one is ready, so a failed grow leaves the recording as it was
+    if( !map( sizeof( Header ) + sizeof(float) * numChannels * newCapacity ) ){
+        if( !growthFailed ){
+            errorLog << __GRT_LOG__ << " Failed to grow " << filename << " to " << newCapacity << " frames, the recording is kept at " << numFrames << " frames!" << std::endl;
+        }
+        growthFailed = true;
+        return false;
+    }
+    growthFailed = false;
+
+    return true;
+}
+
+bool ofxGrtRecorder::map( const unsigned long long fileSize ){
+
+    //The new mapping is created before the old one is released, so the old mapping is still valid if this fails
+#ifdef TARGET_WIN32
+    HANDLE newMappingHandle = CreateFileMappingA( fileHandle, NULL, PAGE_READWRITE, (DWORD)(fileSize >> 32), (DWORD)(fileSize & 0xFFFFFFFF), NULL );
+    if( newMappingHandle == NULL ) return false;
+    unsigned char *newMapping = (unsigned char*)MapViewOfFile( newMappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)fileSize );
+    if( newMapping == NULL ){
+        CloseHandle( newMappingHandle );
+        return false;
+    }
+    unmap();
+    mappingHandle = newMappingHandle;
+#else
+    struct stat info;
+    if( fstat( fileHandle, &info ) != 0 ) return false;
+    if( (unsigned long long)info.st_size < fileSize && ftruncate( fileHandle, (off_t)fileSize ) != 0 ) return false;
+    void *ptr = mmap( NULL, (size_t)fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileHandle, 0 );
+    if( ptr == MAP_FAILED ) return false;
+    unsigned char *newMapping = (unsigned char*)ptr;
+    unmap();
+#endif
+
+    mapping = newMapping;
+    mappingSize = (size_t)fileSize;
+    capacity = (fileSize - sizeof( Header )) / (sizeof(float) * numChannels);
+    return true;
+}
+
+void ofxGrtRecorder::unmap(){
+
+    if( mapping == NULL ) return;
+
+#ifdef TARGET_WIN32
+    FlushViewOfFile( mapping, 0 );
+    UnmapViewOfFile( mapping );
+    CloseHandle( mappingHandle );
+    mappingHandle = NULL;
+#else
+    munmap( mapping, mappingSize );
+#endif
+
+    mapping = NULL;
+    mappingSize = 0;
+    capacity = 0;
+}
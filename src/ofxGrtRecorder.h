@@ -0,0 +1,118 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+#include "GRT/GRT.h"
+
+/**
+ @brief An append-only recording of a multi-channel timeseries, stored as interleaved float frames in a memory-mapped binary file.
+ Appending copies the frames straight into the mapping, so the caller never waits on a write call, the operating system flushes the
+ dirty pages to disk in the background. The file is grown (and remapped) geometrically, so remapping only happens a handful of times
+ however long the recording runs. The growth is done ahead of time by reserveAhead (e.g. from the draw thread) once the mapping is 75%
+ full, write only has to grow the file itself if a single block is larger than the space left. If the file can not be grown the old
+ mapping is kept, so the recording stays open with the frames recorded so far and write returns false until there is space again. Reopening an existing recording maps it back in without reading it, so any frame can be accessed
+ immediately through getFrame.
+
+ The file starts with a small header (magic, version, number of channels and number of frames) followed by the frames. The number of
+ frames in the header is updated as frames are appended, so a recording can be reopened and appended to after the application exits.
+*/
+class ofxGrtRecorder{
+public:
+    ofxGrtRecorder();
+    ~ofxGrtRecorder();
+
+    /**
+     @brief opens a recording, if the file already exists then it must have the same number of channels and new frames will be appended to it
+     @param filename: the path of the recording file
+     @param numChannels: the number of values in each frame
+     @return returns true if the recording was opened successfully, false otherwise
+    */
+    bool open( const std::string &filename, const unsigned int numChannels );
+
+    /**
+     @brief flushes and closes the recording, the file is truncated to the frames that were recorded
+    */
+    void close();
+
+    /**
+     @brief writes numFrames samples for one channel after the last recorded frame. This must be called for every channel before calling advance
+     @param source: the first sample for the channel
+     @param stride: the distance between consecutive samples in the source
+     @return returns true if the samples were written, false if the recording is not open or could not be grown
+    */
+    bool write( const unsigned int channel, const float *source, const size_t stride, const size_t numFrames );
+
+    /**
+     @brief adds the frames written by write to the recording
+    */
+    void advance( const size_t numFrames );
+
+    /**
+     @brief grows the recording if the mapping is at least 75% full, so the remap is done here rather than by write. This should be called
+     regularly from a thread that is allowed to wait on the file system (e.g. the draw thread), by whoever serializes access to the recording
+     @return returns true if there is space in the recording, false if the recording is not open or could not be grown
+    */
+    bool reserveAhead();
+
+    /**
+     @return returns a pointer to the numChannels interleaved values of the frame, or NULL if the frame has not been recorded.
+     The pointer is only valid until the recording is next grown or closed
+    */
+    const float* getFrame( const unsigned long long index ) const;
+
+    bool isOpen() const { return mapping != NULL; }
+    unsigned int getNumChannels() const { return numChannels; }
+    unsigned long long getNumFrames() const { return numFrames; }
+    const std::string& getFilename() const { return filename; }
+
+protected:
+    struct Header{
+        char magic[4];
+        uint32_t version;
+        uint32_t numChannels;
+        uint32_t reserved;
+        uint64_t numFrames;
+    };
+
+    bool reserve( const unsigned long long capacity );
+    bool grow( const unsigned long long newCapacity );
+    bool map( const unsigned long long fileSize );
+    void unmap();
+    float* getFrames() const { return reinterpret_cast< float* >( mapping + sizeof( Header ) ); }
+
+    std::string filename;
+    unsigned int numChannels;
+    unsigned long long numFrames;
+    unsigned long long capacity; ///< The number of frames that fit in the current mapping
+    size_t mappingSize; ///< The number of bytes mapped
+    unsigned char *mapping;
+    bool growthFailed; ///< True if the last attempt to grow the file failed, so the failure is only reported once
+#ifdef TARGET_WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#else
+    int fileHandle;
+#endif
+    GRT::ErrorLog errorLog;
+};
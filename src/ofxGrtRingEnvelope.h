@@ -0,0 +1,149 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+/**
+ @brief Caches min/max summaries over fixed blocks of a ring buffer so the min/max of any slot range can be found without scanning it.
+ Level 0 summarizes blocks of BRANCHING slots, each following level summarizes BRANCHING blocks of the level below.
+ The summaries are updated in O(levels) as each slot is written, and a range query costs O(BRANCHING * levels) regardless of the range length.
+
+ A block is reset when its first slot is written, so the only block with a partial summary is the one the ring head is currently inside,
+ queries descend into that block instead of using its summary.
+*/
+class ofxGrtRingEnvelope{
+public:
+    static const unsigned int BRANCHING = 16;
+
+    ofxGrtRingEnvelope(){
+        length = 0;
+    }
+
+    /**
+     @brief allocates the summaries for a ring with the given number of slots
+    */
+    void setup( const unsigned int length ){
+        this->length = length;
+        levels.clear();
+        unsigned int blockSize = BRANCHING;
+        while( length > 0 ){
+            Level level;
+            level.blockSize = blockSize;
+            const unsigned int numBlocks = (length + blockSize - 1) / blockSize;
+            level.minValues.resize( numBlocks, 0 );
+            level.maxValues.resize( numBlocks, 0 );
+            levels.push_back( level );
+            if( numBlocks <= 1 ) break;
+            blockSize *= BRANCHING;
+        }
+    }
+
+    /**
+     @brief updates the summaries after the value at slot has been written to the ring
+    */
+    void write( const unsigned int slot, const float value ){
+        for(size_t k=0; k<levels.size(); k++){
+            Level &level = levels[k];
+            const unsigned int block = slot / level.blockSize;
+            if( slot % level.blockSize == 0 ){
+                level.minValues[ block ] = value;
+                level.maxValues[ block ] = value;
+            }else{
+                level.minValues[ block ] = std::min( level.minValues[ block ], value );
+                level.maxValues[ block ] = std::max( level.maxValues[ block ], value );
+            }
+        }
+    }
+
+    /**
+     @brief recomputes all the summaries from the ring, this should be called if the ring is overwritten without calling write
+     @param ring: anything that can be indexed like a const float* (e.g. a float pointer or an ofxGrtSampleBuffer::Channel)
+    */
+    template< class Ring >
+    void rebuild( const Ring &ring ){
+        for(unsigned int i=0; i<length; i++){
+            write( i, ring[i] );
+        }
+    }
+
+    /**
+     @brief finds the min/max of the ring slots [begin,end), the range must not wrap around the end of the ring
+     @param ring: the ring the summaries were built from
+     @param head: the current write position of the ring
+    */
+    template< class Ring >
+    void getRange( const Ring &ring, const unsigned int head, const unsigned int begin, const unsigned int end, float &minValue, float &maxValue ) const {
+        minValue = std::numeric_limits<float>::max();
+        maxValue = -std::numeric_limits<float>::max();
+        getRange( (int)levels.size()-1, ring, head, begin, end, minValue, maxValue );
+    }
+
+protected:
+    struct Level{
+        unsigned int blockSize;
+        std::vector< float > minValues;
+        std::vector< float > maxValues;
+    };
+
+    template< class Ring >
+    void getRange( const int k, const Ring &ring, const unsigned int head, const unsigned int begin, const unsigned int end, float &minValue, float &maxValue ) const {
+        if( begin >= end ) return;
+
+        if( k < 0 ){
+            for(unsigned int i=begin; i<end; i++){
+                minValue = std::min( minValue, ring[i] );
+                maxValue = std::max( maxValue, ring[i] );
+            }
+            return;
+        }
+
+        const Level &level = levels[k];
+        const unsigned int blockSize = level.blockSize;
+        const unsigned int firstBlock = (begin + blockSize - 1) / blockSize;
+        const unsigned int lastBlock = end / blockSize;
+
+        //The last block in the ring can be shorter than blockSize, it is only complete if the range reaches the end of the ring
+        const unsigned int numFullBlocks = end == length ? (unsigned int)level.minValues.size() : lastBlock;
+
+        if( firstBlock >= numFullBlocks ){
+            getRange( k-1, ring, head, begin, end, minValue, maxValue );
+            return;
+        }
+
+        getRange( k-1, ring, head, begin, firstBlock*blockSize, minValue, maxValue );
+        for(unsigned int b=firstBlock; b<numFullBlocks; b++){
+            const unsigned int blockStart = b*blockSize;
+            const unsigned int blockEnd = std::min( blockStart + blockSize, length );
+            if( blockStart < head && head < blockEnd ){
+                getRange( k-1, ring, head, blockStart, blockEnd, minValue, maxValue );
+            }else{
+                minValue = std::min( minValue, level.minValues[b] );
+                maxValue = std::max( maxValue, level.maxValues[b] );
+            }
+        }
+        getRange( k-1, ring, head, std::min( numFullBlocks*blockSize, end ), end, minValue, maxValue );
+    }
+
+    unsigned int length;
+    std::vector< Level > levels;
+};
@@ -0,0 +1,91 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "ofxGrtSampleBuffer.h"
+
+/**
+ @brief Works out how an ofxGrtSampleBuffer ring is mirrored into a float vertex buffer. Each channel is stored twice ([ring][ring]), so the samples
+ from the oldest (at the head of the ring) to the newest are always contiguous, starting at getFirstVertex. This does not touch GL, the writes are made
+ through a Writer, any class with a write( const size_t offset, const unsigned int count, const float *data ) method where offset and count are in floats.
+*/
+class ofxGrtRingMirror{
+public:
+    /**
+     @brief returns the first vertex of the channel, drawing the length of the ring from there gives the samples from oldest to newest
+     @param head: the ring index of the oldest sample
+    */
+    static unsigned int getFirstVertex( const unsigned int channel, const unsigned int length, const unsigned int head ){
+        return channel*2*length + head;
+    }
+
+    /**
+     @brief fills mirror with every channel of the buffer, this is the data a newly allocated vertex buffer is created with
+    */
+    static void build( const ofxGrtSampleBuffer &buffer, std::vector< float > &mirror ){
+        const unsigned int length = buffer.getLength();
+        mirror.resize( (size_t)buffer.getNumChannels()*2*length );
+        for(unsigned int j=0; j<buffer.getNumChannels(); j++){
+            float *channelMirror = &mirror[ (size_t)j*2*length ];
+            buffer.decode( j, 0, length, channelMirror );
+            std::copy( channelMirror, channelMirror+length, channelMirror+length );
+        }
+    }
+
+    /**
+     @brief writes the last numPending samples of every channel (the samples just before the head) into both copies of the mirror. The pending samples
+     are at most two contiguous runs of the ring, so this is at most four writes per channel however long the ring is
+     @param head: the ring index of the oldest sample, the next sample will be written there
+     @param numPending: the number of samples written since the mirror was last updated, this is clamped to the length of the ring
+     @param scratch: holds the decoded samples when the buffer uses a compact format, reusing it between calls avoids allocating
+    */
+    template< class Writer >
+    static void update( const ofxGrtSampleBuffer &buffer, const unsigned int head, const unsigned int numPending, std::vector< float > &scratch, Writer &writer ){
+        const unsigned int length = buffer.getLength();
+        const unsigned int count = std::min( numPending, length );
+        if( count == 0 ) return;
+
+        const unsigned int start = head >= count ? head - count : head + length - count;
+        const unsigned int firstRun = std::min( count, length - start );
+        const unsigned int secondRun = count - firstRun;
+        for(unsigned int j=0; j<buffer.getNumChannels(); j++){
+            //The vertex buffer always holds floats, so the compact formats are decoded into the scratch buffer first
+            const float *channelData = buffer.getFloatData( j );
+            const float *firstData = channelData ? channelData + start : NULL;
+            const float *secondData = channelData;
+            if( channelData == NULL ){
+                scratch.resize( count );
+                buffer.decode( j, start, firstRun, scratch.data() );
+                buffer.decode( j, 0, secondRun, scratch.data() + firstRun );
+                firstData = scratch.data();
+                secondData = scratch.data() + firstRun;
+            }
+            for(unsigned int copy=0; copy<2; copy++){
+                const size_t mirrorOffset = ((size_t)j*2 + copy)*length;
+                writer.write( mirrorOffset + start, firstRun, firstData );
+                if( secondRun > 0 ){
+                    writer.write( mirrorOffset, secondRun, secondData );
+                }
+            }
+        }
+    }
+};
@@ -0,0 +1,247 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+/**
+ @brief The storage types supported by the plot buffers. The quantized formats store (value - offset) / scale, so a channel with a scale of 1 and an
+ offset of 0 stores raw int16 (e.g. ADC counts) or uint8 values exactly, while a scale of 1/255 stores normalized [0 1] values (e.g. likelihoods) in a uint8.
+*/
+enum ofxGrtSampleFormat{
+    OFXGRT_SAMPLE_FLOAT=0, ///< 32-bit float, values are stored as they are
+    OFXGRT_SAMPLE_INT16, ///< 16-bit signed integer, [-32768 32767] * scale + offset
+    OFXGRT_SAMPLE_HALF, ///< 16-bit IEEE half float, about 3 significant digits over a wide range
+    OFXGRT_SAMPLE_UINT8 ///< 8-bit unsigned integer, [0 255] * scale + offset
+};
+
+/**
+ @brief returns the number of bytes used to store one sample in the format
+*/
+inline size_t ofxGrtGetSampleSize( const ofxGrtSampleFormat format ){
+    switch( format ){
+        case OFXGRT_SAMPLE_INT16: return 2;
+        case OFXGRT_SAMPLE_HALF: return 2;
+        case OFXGRT_SAMPLE_UINT8: return 1;
+        default: return 4;
+    }
+}
+
+/**
+ @brief converts a float to an IEEE half float, rounding to the nearest even value and saturating to infinity
+*/
+inline unsigned short ofxGrtFloatToHalf( const float value ){
+    unsigned int bits;
+    std::memcpy( &bits, &value, sizeof(bits) );
+    const unsigned short sign = (unsigned short)((bits >> 16) & 0x8000);
+    const unsigned int absBits = bits & 0x7FFFFFFF;
+
+    if( absBits >= 0x7F800000 ) return sign | (absBits > 0x7F800000 ? 0x7E00 : 0x7C00); //NaN or infinity
+    if( absBits >= 0x477FF000 ) return sign | 0x7C00; //Too large, this includes values that round up to infinity
+    if( absBits < 0x38800000 ){
+        //Subnormal half, shift the mantissa (with its implicit bit) into place
+        if( absBits < 0x33000000 ) return sign;
+        const unsigned int exponent = absBits >> 23;
+        const unsigned int mantissa = (absBits & 0x7FFFFF) | 0x800000;
+        const unsigned int shift = 126 - exponent;
+        unsigned int half = mantissa >> shift;
+        const unsigned int remainder = mantissa & ((1u << shift) - 1);
+        const unsigned int halfway = 1u << (shift - 1);
+        if( remainder > halfway || (remainder == halfway && (half & 1)) ) half++;
+        return sign | (unsigned short)half;
+    }
+    //Normal half, rebias the exponent and round the mantissa (a carry into the exponent is still correct)
+    unsigned int half = (absBits - 0x38000000) >> 13;
+    const unsigned int remainder = absBits & 0x1FFF;
+    if( remainder > 0x1000 || (remainder == 0x1000 && (half & 1)) ) half++;
+    return sign | (unsigned short)half;
+}
+
+/**
+ @brief converts an IEEE half float to a float
+*/
+inline float ofxGrtHalfToFloat( const unsigned short value ){
+    const unsigned int sign = (unsigned int)(value & 0x8000) << 16;
+    const unsigned int exponent = (value >> 10) & 0x1F;
+    const unsigned int mantissa = value & 0x3FF;
+    unsigned int bits;
+    if( exponent == 0 ){
+        //Zero or a subnormal half, all subnormal halfs are normal floats
+        const float result = std::ldexp( (float)mantissa, -24 );
+        return sign ? -result : result;
+    }else if( exponent == 0x1F ){
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    }else{
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float result;
+    std::memcpy( &result, &bits, sizeof(result) );
+    return result;
+}
+
+/**
+ @brief Channel-major sample storage (channel n occupies [n*length, (n+1)*length)) in one of the ofxGrtSampleFormat types,
+ with a scale and offset per channel for the quantized formats. Values are always written and read as floats, so the format only changes
+ the memory used and the precision of the stored values.
+*/
+class ofxGrtSampleBuffer{
+public:
+    /**
+     @brief reads a single channel of the buffer, this can be used anywhere a const float* ring is indexed (e.g. by ofxGrtRingEnvelope)
+    */
+    class Channel{
+    public:
+        Channel( const ofxGrtSampleBuffer &buffer, const unsigned int channel ) : buffer( buffer ), channel( channel ), base( (size_t)channel*buffer.length ) {}
+        float operator[]( const unsigned int index ) const { return buffer.decode( channel, base + index ); }
+    protected:
+        const ofxGrtSampleBuffer &buffer;
+        const unsigned int channel;
+        const size_t base;
+    };
+
+    ofxGrtSampleBuffer(){
+        format = OFXGRT_SAMPLE_FLOAT;
+        numChannels = 0;
+        length = 0;
+    }
+
+    /**
+     @brief allocates the buffer and fills it with value. The scale and offset of existing channels are kept, new channels default to a scale of 1 and an offset of 0
+    */
+    void setup( const ofxGrtSampleFormat format, const unsigned int numChannels, const unsigned int length, const float value ){
+        this->format = format;
+        this->numChannels = numChannels;
+        this->length = length;
+        scales.resize( numChannels, 1.0f );
+        offsets.resize( numChannels, 0.0f );
+        floatData.clear();
+        int16Data.clear();
+        halfData.clear();
+        uint8Data.clear();
+        const size_t size = (size_t)numChannels * length;
+        switch( format ){
+            case OFXGRT_SAMPLE_INT16: int16Data.resize( size ); break;
+            case OFXGRT_SAMPLE_HALF: halfData.resize( size ); break;
+            case OFXGRT_SAMPLE_UINT8: uint8Data.resize( size ); break;
+            default: floatData.resize( size ); break;
+        }
+        fill( value );
+    }
+
+    void clear(){
+        setup( format, 0, 0, 0 );
+    }
+
+    /**
+     @brief sets how the values of a channel are quantized, the stored value is (value - offset) / scale. Values already in the buffer are not converted
+    */
+    void setScale( const unsigned int channel, const float scale, const float offset ){
+        if( channel >= numChannels || scale == 0 ) return;
+        scales[ channel ] = scale;
+        offsets[ channel ] = offset;
+    }
+
+    void fill( const float value ){
+        for(unsigned int j=0; j<numChannels; j++){
+            for(unsigned int i=0; i<length; i++){
+                set( j, i, value );
+            }
+        }
+    }
+
+    inline float get( const unsigned int channel, const unsigned int index ) const {
+        return decode( channel, (size_t)channel*length + index );
+    }
+
+    inline void set( const unsigned int channel, const unsigned int index, const float value ){
+        const size_t i = (size_t)channel*length + index;
+        switch( format ){
+            case OFXGRT_SAMPLE_INT16:
+                int16Data[i] = (short)quantize( value, channel, -32768.0f, 32767.0f );
+                break;
+            case OFXGRT_SAMPLE_HALF:
+                halfData[i] = ofxGrtFloatToHalf( (value - offsets[channel]) / scales[channel] );
+                break;
+            case OFXGRT_SAMPLE_UINT8:
+                uint8Data[i] = (unsigned char)quantize( value, channel, 0.0f, 255.0f );
+                break;
+            default:
+                floatData[i] = value;
+                break;
+        }
+    }
+
+    /**
+     @brief copies count values of a channel, starting at index, into dest as floats
+    */
+    void decode( const unsigned int channel, const unsigned int index, const unsigned int count, float *dest ) const {
+        const size_t base = (size_t)channel*length + index;
+        if( format == OFXGRT_SAMPLE_FLOAT ){
+            std::copy( floatData.begin() + base, floatData.begin() + base + count, dest );
+            return;
+        }
+        for(unsigned int i=0; i<count; i++){
+            dest[i] = decode( channel, base + i );
+        }
+    }
+
+    Channel getChannel( const unsigned int channel ) const { return Channel( *this, channel ); }
+
+    /**
+     @return returns a pointer to the values of the channel if the buffer stores floats, NULL otherwise
+    */
+    float* getFloatData( const unsigned int channel ){ return format == OFXGRT_SAMPLE_FLOAT ? &floatData[ (size_t)channel*length ] : NULL; }
+    const float* getFloatData( const unsigned int channel ) const { return format == OFXGRT_SAMPLE_FLOAT ? &floatData[ (size_t)channel*length ] : NULL; }
+
+    ofxGrtSampleFormat getFormat() const { return format; }
+    unsigned int getNumChannels() const { return numChannels; }
+    unsigned int getLength() const { return length; }
+    float getScale( const unsigned int channel ) const { return scales[ channel ]; }
+    float getOffset( const unsigned int channel ) const { return offsets[ channel ]; }
+    size_t getMemorySize() const { return (size_t)numChannels * length * ofxGrtGetSampleSize( format ); }
+
+protected:
+    inline float decode( const unsigned int channel, const size_t i ) const {
+        switch( format ){
+            case OFXGRT_SAMPLE_INT16: return int16Data[i] * scales[channel] + offsets[channel];
+            case OFXGRT_SAMPLE_HALF: return ofxGrtHalfToFloat( halfData[i] ) * scales[channel] + offsets[channel];
+            case OFXGRT_SAMPLE_UINT8: return uint8Data[i] * scales[channel] + offsets[channel];
+            default: return floatData[i];
+        }
+    }
+
+    inline float quantize( const float value, const unsigned int channel, const float minValue, const float maxValue ) const {
+        const float q = std::floor( (value - offsets[channel]) / scales[channel] + 0.5f );
+        return q >= minValue ? (q <= maxValue ? q : maxValue) : minValue; //NaN is stored as minValue
+    }
+
+    ofxGrtSampleFormat format;
+    unsigned int numChannels;
+    unsigned int length;
+    std::vector< float > scales;
+    std::vector< float > offsets;
+    std::vector< float > floatData;
+    std::vector< short > int16Data;
+    std::vector< unsigned short > halfData;
+    std::vector< unsigned char > uint8Data;
+};
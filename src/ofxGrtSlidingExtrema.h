@@ -0,0 +1,120 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <vector>
+#include <limits>
+
+/**
+ @brief Tracks the minimum and maximum value of the last windowSize samples pushed into it.
+ The min and max are each kept in a monotonic queue, so push is O(1) amortized and getMin/getMax are O(1).
+ The queues live in fixed size rings that are allocated in setup, so pushing a sample never allocates.
+*/
+class ofxGrtSlidingExtrema{
+public:
+    ofxGrtSlidingExtrema(){
+        windowSize = 0;
+        nextIndex = 0;
+    }
+
+    /**
+     @brief sets the size of the sliding window and clears any existing samples
+     @param windowSize: the number of samples the min/max should be computed over
+    */
+    void setup( const unsigned int windowSize ){
+        this->windowSize = windowSize;
+        minQueue.setup( windowSize );
+        maxQueue.setup( windowSize );
+        nextIndex = 0;
+    }
+
+    /**
+     @brief clears the window and treats it as if it was completely filled with value
+    */
+    void fill( const float value ){
+        minQueue.clear();
+        maxQueue.clear();
+        if( windowSize == 0 ) return;
+        //With a constant window only the newest sample needs to be kept, it expires after windowSize new samples
+        minQueue.pushBack( windowSize-1, value );
+        maxQueue.pushBack( windowSize-1, value );
+        nextIndex = windowSize;
+    }
+
+    /**
+     @brief adds a new sample to the window, evicting the oldest sample if the window is full
+    */
+    void push( const float value ){
+        if( windowSize == 0 ) return;
+
+        const unsigned long long index = nextIndex++;
+
+        //Evict the samples that have fallen out of the window
+        while( !minQueue.empty() && minQueue.front().index + windowSize <= index ) minQueue.popFront();
+        while( !maxQueue.empty() && maxQueue.front().index + windowSize <= index ) maxQueue.popFront();
+
+        //Any older sample that is not smaller (or larger) than the new value can never be the min (or max) again
+        while( !minQueue.empty() && minQueue.back().value >= value ) minQueue.popBack();
+        while( !maxQueue.empty() && maxQueue.back().value <= value ) maxQueue.popBack();
+
+        minQueue.pushBack( index, value );
+        maxQueue.pushBack( index, value );
+    }
+
+    float getMin() const { return minQueue.empty() ? std::numeric_limits<float>::max() : minQueue.front().value; }
+    float getMax() const { return maxQueue.empty() ? -std::numeric_limits<float>::max() : maxQueue.front().value; }
+
+protected:
+    struct Entry{
+        unsigned long long index;
+        float value;
+    };
+
+    /**
+     @brief a fixed capacity double ended queue, the window can never hold more than windowSize entries
+    */
+    class Queue{
+    public:
+        Queue(){ head = 0; size = 0; }
+        void setup( const unsigned int capacity ){ entries.resize( capacity ); clear(); }
+        void clear(){ head = 0; size = 0; }
+        bool empty() const { return size == 0; }
+        const Entry& front() const { return entries[ head ]; }
+        const Entry& back() const { return entries[ wrap( head + size - 1 ) ]; }
+        void popFront(){ head = wrap( head + 1 ); size--; }
+        void popBack(){ size--; }
+        void pushBack( const unsigned long long index, const float value ){
+            Entry &entry = entries[ wrap( head + size ) ];
+            entry.index = index;
+            entry.value = value;
+            size++;
+        }
+    protected:
+        unsigned int wrap( const unsigned int i ) const { return i < entries.size() ? i : i - (unsigned int)entries.size(); }
+        std::vector< Entry > entries;
+        unsigned int head;
+        unsigned int size;
+    };
+
+    unsigned int windowSize;
+    unsigned long long nextIndex;
+    Queue minQueue;
+    Queue maxQueue;
+};
@@ -0,0 +1,92 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <atomic>
+#include <vector>
+
+/**
+ @brief A lock-free latest-value buffer (a triple buffer) for passing whole frames from one producer thread to one consumer thread.
+ The producer writes a complete frame into its own buffer and publishes it by swapping that buffer with the shared middle buffer. The consumer takes
+ the latest published frame by swapping its own buffer with the middle buffer. Both swaps are a single atomic exchange, so neither side ever waits
+ for the other (unlike a seqlock, the reader never has to retry) and each buffer is only ever touched by one thread at a time, so the consumer can
+ not see a torn frame. Frames published faster than they are read are replaced, only the latest frame is kept.
+*/
+class ofxGrtSnapshotBuffer{
+public:
+    ofxGrtSnapshotBuffer(){
+        frameSize = 0;
+        writeBuffer = 0;
+        readBuffer = 1;
+        middleBuffer = 2;
+    }
+
+    /**
+     @brief allocates the buffers and fills them with 0, this must not be called while a producer or consumer is using the buffer
+     @param frameSize: the number of values in each frame
+    */
+    void setup( const unsigned int frameSize ){
+        this->frameSize = frameSize;
+        for(unsigned int i=0; i<3; i++){
+            buffers[i].assign( frameSize, 0.0f );
+        }
+        writeBuffer = 0;
+        readBuffer = 1;
+        middleBuffer.store( 2, std::memory_order_relaxed );
+    }
+
+    /**
+     @brief returns the frame the producer should write into, the frame is published by the next call to publish. This should only be called from the producer thread
+    */
+    float* getWriteFrame(){ return &buffers[ writeBuffer ][0]; }
+
+    /**
+     @brief publishes the frame returned by getWriteFrame, this should only be called from the producer thread
+    */
+    void publish(){
+        writeBuffer = middleBuffer.exchange( writeBuffer | NEW_FRAME, std::memory_order_acq_rel ) & BUFFER_MASK;
+    }
+
+    /**
+     @brief takes the latest published frame if there is one, this should only be called from the consumer thread
+     @return returns true if a new frame was published since the last call, the frame can then be read with getReadFrame
+    */
+    bool acquire(){
+        if( !(middleBuffer.load( std::memory_order_relaxed ) & NEW_FRAME) ) return false;
+        readBuffer = middleBuffer.exchange( readBuffer, std::memory_order_acq_rel ) & BUFFER_MASK;
+        return true;
+    }
+
+    /**
+     @brief returns the frame taken by the last call to acquire, this should only be called from the consumer thread
+    */
+    const float* getReadFrame() const { return &buffers[ readBuffer ][0]; }
+
+    unsigned int getFrameSize() const { return frameSize; }
+
+protected:
+    enum{ BUFFER_MASK=3, NEW_FRAME=4 };
+
+    unsigned int frameSize;
+    std::vector< float > buffers[3];
+    unsigned int writeBuffer; ///< Only accessed by the producer
+    unsigned int readBuffer; ///< Only accessed by the consumer
+    std::atomic< unsigned int > middleBuffer; ///< The index of the shared buffer, with NEW_FRAME set if the producer has published it since the consumer last took it
+};
@@ -0,0 +1,114 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <vector>
+
+/**
+ @brief A run-length encoded window over the last windowSize keys pushed into it.
+ Consecutive equal keys are merged into one span, so rendering can issue one draw call per span rather than one per sample.
+ Pushing a key is O(1) and evicts the oldest key once the window is full. The spans are stored in a fixed size ring so pushing never allocates.
+*/
+class ofxGrtSpanList{
+public:
+    struct Span{
+        int key;
+        unsigned int length;
+    };
+
+    ofxGrtSpanList(){
+        windowSize = 0;
+        numValues = 0;
+        head = 0;
+        numSpans = 0;
+    }
+
+    /**
+     @brief sets the size of the window and removes all the spans
+    */
+    void setup( const unsigned int windowSize ){
+        this->windowSize = windowSize;
+        spans.resize( windowSize );
+        clear();
+    }
+
+    void clear(){
+        numValues = 0;
+        head = 0;
+        numSpans = 0;
+    }
+
+    /**
+     @brief appends count copies of key to the window, evicting the oldest keys if the window is full
+    */
+    void push( const int key, unsigned int count = 1 ){
+        if( windowSize == 0 || count == 0 ) return;
+        if( count > windowSize ){
+            clear();
+            count = windowSize;
+        }
+
+        if( numSpans > 0 && back().key == key ){
+            spans[ wrap( head + numSpans - 1 ) ].length += count;
+        }else{
+            //Make room for the new span, this only happens if every span in the window has a length of one
+            if( numSpans == windowSize ) evict( spans[ head ].length );
+            Span &span = spans[ wrap( head + numSpans ) ];
+            span.key = key;
+            span.length = count;
+            numSpans++;
+        }
+        numValues += count;
+
+        if( numValues > windowSize ) evict( numValues - windowSize );
+    }
+
+    unsigned int getNumSpans() const { return numSpans; }
+
+    /**
+     @brief returns the i'th span, where span 0 is the oldest
+    */
+    const Span& operator[]( const unsigned int i ) const { return spans[ wrap( head + i ) ]; }
+
+protected:
+    const Span& back() const { return spans[ wrap( head + numSpans - 1 ) ]; }
+
+    void evict( unsigned int count ){
+        while( count > 0 && numSpans > 0 ){
+            Span &front = spans[ head ];
+            const unsigned int n = count < front.length ? count : front.length;
+            front.length -= n;
+            numValues -= n;
+            count -= n;
+            if( front.length == 0 ){
+                head = wrap( head + 1 );
+                numSpans--;
+            }
+        }
+    }
+
+    unsigned int wrap( const unsigned int i ) const { return i < windowSize ? i : i - windowSize; }
+
+    unsigned int windowSize;
+    unsigned int numValues;
+    unsigned int head;
+    unsigned int numSpans;
+    std::vector< Span > spans;
+};
@@ -0,0 +1,244 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+/**
+ @brief Estimates a single quantile of a stream with the P-Square algorithm (Jain and Chlamtac, 1985).
+ Five markers are kept whatever the length of the stream, so add is O(1) and the estimate is available at any time.
+*/
+class ofxGrtP2Quantile{
+public:
+    ofxGrtP2Quantile(){
+        setup( 0.5f );
+    }
+
+    /**
+     @brief sets the probability of the quantile that is estimated (e.g. 0.99 for the 99th percentile) and clears the estimator
+    */
+    void setup( const float probability ){
+        p = probability < 0 ? 0 : (probability > 1 ? 1 : probability);
+        increments[0] = 0; increments[1] = p/2; increments[2] = p; increments[3] = (1+p)/2; increments[4] = 1;
+        clear();
+    }
+
+    void clear(){
+        count = 0;
+        for(unsigned int i=0; i<5; i++){
+            heights[i] = 0;
+            positions[i] = i+1;
+        }
+        desired[0] = 1; desired[1] = 1+2*p; desired[2] = 1+4*p; desired[3] = 3+2*p; desired[4] = 5;
+    }
+
+    void add( const float value ){
+        if( !std::isfinite( value ) ) return;
+
+        //The first five values are the initial marker heights
+        if( count < 5 ){
+            heights[ count++ ] = value;
+            if( count == 5 ) std::sort( heights, heights+5 );
+            return;
+        }
+        count++;
+
+        //Find the cell the value falls in, extending the end markers if needed
+        unsigned int k;
+        if( value < heights[0] ){ heights[0] = value; k = 0; }
+        else if( value >= heights[4] ){ heights[4] = value; k = 3; }
+        else{
+            k = 0;
+            while( value >= heights[k+1] ) k++;
+        }
+        for(unsigned int i=k+1; i<5; i++) positions[i]++;
+        for(unsigned int i=0; i<5; i++) desired[i] += increments[i];
+
+        //Move the middle markers towards their desired positions, using the parabolic prediction if it keeps the heights ordered
+        for(unsigned int i=1; i<4; i++){
+            const double d = desired[i] - positions[i];
+            if( (d >= 1 && positions[i+1] - positions[i] > 1) || (d <= -1 && positions[i-1] - positions[i] < -1) ){
+                const int s = d > 0 ? 1 : -1;
+                const double q = parabolic( i, s );
+                if( heights[i-1] < q && q < heights[i+1] ) heights[i] = q;
+                else heights[i] = heights[i] + s * (heights[i+s] - heights[i]) / (positions[i+s] - positions[i]);
+                positions[i] += s;
+            }
+        }
+    }
+
+    /**
+     @return returns the estimated quantile, 0 if no values have been added
+    */
+    float get() const {
+        if( count == 0 ) return 0;
+        if( count >= 5 ) return (float)heights[2];
+        //Not enough values for the markers yet, so use the exact quantile of the values seen so far
+        double sorted[5];
+        std::copy( heights, heights+count, sorted );
+        std::sort( sorted, sorted+count );
+        return (float)sorted[ (unsigned int)( p*(count-1) + 0.5f ) ];
+    }
+
+    unsigned long long getCount() const { return count; }
+
+protected:
+    double parabolic( const unsigned int i, const int s ) const {
+        const double n0 = positions[i-1], n1 = positions[i], n2 = positions[i+1];
+        return heights[i] + s / (n2 - n0) * ( (n1 - n0 + s) * (heights[i+1] - heights[i]) / (n2 - n1) + (n2 - n1 - s) * (heights[i] - heights[i-1]) / (n1 - n0) );
+    }
+
+    float p;
+    unsigned long long count;
+    double heights[5];
+    double positions[5];
+    double desired[5];
+    double increments[5];
+};
+
+/**
+ @brief Running statistics of the values in a sliding window (e.g. a plot channel ring): the mean, variance and RMS are exact and updated in O(1)
+ per sample from the value entering and the value leaving the window. Non-finite values are ignored.
+ The lower, median and upper quantiles are P-Square estimates. P-Square cannot forget values, so the estimators are restarted every windowSize values and
+ the estimate from the previous window is reported until the new estimators have seen half a window, this keeps the quantiles within about one window of the data.
+*/
+class ofxGrtStreamingStats{
+public:
+    struct Summary{
+        float mean;
+        float variance;
+        float standardDeviation;
+        float rms;
+        float lowerQuantile;
+        float median;
+        float upperQuantile;
+    };
+
+    ofxGrtStreamingStats(){
+        setup( 0, 0.01f, 0.99f );
+    }
+
+    /**
+     @brief sets the window size and the probabilities of the lower and upper quantiles, and clears the statistics
+    */
+    void setup( const unsigned int windowSize, const float lowerProbability, const float upperProbability ){
+        this->windowSize = windowSize;
+        for(unsigned int i=0; i<2; i++){
+            quantiles[i][0].setup( lowerProbability );
+            quantiles[i][1].setup( 0.5f );
+            quantiles[i][2].setup( upperProbability );
+        }
+        clear();
+    }
+
+    void clear(){
+        shift = 0;
+        sum = 0;
+        sumSquares = 0;
+        numValues = 0;
+        active = 0;
+        numQuantileValues = 0;
+        hasPrevious = false;
+        for(unsigned int i=0; i<2; i++){
+            for(unsigned int j=0; j<3; j++) quantiles[i][j].clear();
+        }
+    }
+
+    /**
+     @brief adds a value to the window without evicting one, this is used to fill the window (e.g. when it is rebuilt from a ring)
+    */
+    void add( const float value ){
+        if( std::isfinite( value ) ){
+            //The sums are taken around the first value, so the variance does not lose precision when the mean is large compared to the spread
+            if( numValues == 0 ){
+                shift = value;
+                sum = 0;
+                sumSquares = 0;
+            }
+            const double x = value - shift;
+            sum += x;
+            sumSquares += x*x;
+            numValues++;
+        }
+        addQuantiles( value );
+    }
+
+    /**
+     @brief adds a value to the window and removes the evicted value (the oldest value in the window), the window size stays the same
+    */
+    void push( const float value, const float evicted ){
+        if( std::isfinite( evicted ) && numValues > 0 ){
+            const double x = evicted - shift;
+            sum -= x;
+            sumSquares -= x*x;
+            numValues--;
+        }
+        add( value );
+    }
+
+    Summary getSummary() const {
+        Summary summary;
+        const double n = (double)numValues;
+        const double mean = n > 0 ? sum / n : 0;
+        const double variance = n > 0 ? std::max( sumSquares / n - mean*mean, 0.0 ) : 0;
+        summary.mean = (float)(shift + mean);
+        summary.variance = (float)variance;
+        summary.standardDeviation = (float)std::sqrt( variance );
+        summary.rms = (float)std::sqrt( variance + (double)summary.mean*summary.mean );
+        summary.lowerQuantile = getQuantile( 0 );
+        summary.median = getQuantile( 1 );
+        summary.upperQuantile = getQuantile( 2 );
+        return summary;
+    }
+
+    float getLowerQuantile() const { return getQuantile( 0 ); }
+    float getUpperQuantile() const { return getQuantile( 2 ); }
+    unsigned int getNumValues() const { return numValues; }
+
+protected:
+    void addQuantiles( const float value ){
+        if( windowSize == 0 ) return;
+        for(unsigned int j=0; j<3; j++) quantiles[ active ][j].add( value );
+        //Restart the estimators each window, the finished estimators are kept for reporting until the new ones have seen half a window
+        if( ++numQuantileValues >= windowSize ){
+            active = 1 - active;
+            for(unsigned int j=0; j<3; j++) quantiles[ active ][j].clear();
+            numQuantileValues = 0;
+            hasPrevious = true;
+        }
+    }
+
+    float getQuantile( const unsigned int j ) const {
+        const bool useActive = !hasPrevious || numQuantileValues*2 >= windowSize;
+        return quantiles[ useActive ? active : 1 - active ][j].get();
+    }
+
+    unsigned int windowSize;
+    double shift;
+    double sum; ///< The sum of (value - shift) over the finite values in the window
+    double sumSquares;
+    unsigned int numValues; ///< The number of finite values in the window
+    ofxGrtP2Quantile quantiles[2][3]; ///< Two generations of the lower, median and upper estimators
+    unsigned int active; ///< The generation that new values are added to
+    unsigned int numQuantileValues; ///< The number of values added to the active generation
+    bool hasPrevious;
+};
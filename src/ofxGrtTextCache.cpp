@@ -0,0 +1,67 @@
+#include "ofxGrtTextCache.h"
+
+ofxGrtTextCache::ofxGrtTextCache( const size_t maxSize ){
+    this->maxSize = maxSize;
+}
+
+ofxGrtTextCache::~ofxGrtTextCache(){
+}
+
+bool ofxGrtTextCache::drawString( const ofTrueTypeFont *font, const std::string &text, const float x, const float y ){
+
+    Entry *entry = getEntry( font, text );
+    if( entry == NULL ) return false;
+
+    //Text needs alpha blending, the plots disable it before drawing their text so enable it just for the glyphs.
+    //If blending is already enabled then the current blend function is kept (e.g. the premultiplied blending used by ofxGrtCachedLayer)
+    const bool blending = ofGetStyle().blendingMode != OF_BLENDMODE_DISABLED;
+    if( !blending ) ofEnableAlphaBlending();
+    ofPushMatrix();
+    ofTranslate( x, y );
+    const ofTexture &texture = font->getFontTexture();
+    texture.bind();
+    entry->mesh.draw();
+    texture.unbind();
+    ofPopMatrix();
+    if( !blending ) ofDisableAlphaBlending();
+
+    return true;
+}
+
+ofRectangle ofxGrtTextCache::getStringBoundingBox( const ofTrueTypeFont *font, const std::string &text ){
+    Entry *entry = getEntry( font, text );
+    if( entry == NULL ) return ofRectangle();
+    return entry->bounds;
+}
+
+void ofxGrtTextCache::clear(){
+    entries.clear();
+}
+
+ofxGrtTextCache::Entry* ofxGrtTextCache::getEntry( const ofTrueTypeFont *font, const std::string &text ){
+
+    if( font == NULL || !font->isLoaded() ) return NULL;
+
+    const uint64_t frame = ofGetFrameNum();
+    const Key key( font, text );
+
+    std::map< Key, Entry >::iterator iter = entries.find( key );
+    if( iter != entries.end() ){
+        iter->second.lastUsedFrame = frame;
+        return &iter->second;
+    }
+
+    //Evict anything that was not used in this frame or the last one before adding a new entry
+    if( entries.size() >= maxSize ){
+        for(iter = entries.begin(); iter != entries.end(); ){
+            if( iter->second.lastUsedFrame + 1 < frame ) iter = entries.erase( iter );
+            else ++iter;
+        }
+    }
+
+    Entry &entry = entries[ key ];
+    entry.mesh = font->getStringMesh( text, 0, 0, ofIsVFlipped() );
+    entry.bounds = font->getStringBoundingBox( text, 0, 0 );
+    entry.lastUsedFrame = frame;
+    return &entry;
+}
@@ -0,0 +1,65 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include "ofMain.h"
+#include <map>
+
+/**
+ @brief Caches the glyph mesh and bounding box of each string drawn with a font, so text that does not change between frames
+ (plot titles, axis labels, throttled value readouts) is laid out once and then drawn straight from the cached mesh.
+ Entries that have not been used for a frame are evicted once the cache grows past its maximum size.
+*/
+class ofxGrtTextCache{
+public:
+    ofxGrtTextCache( const size_t maxSize = 128 );
+    ~ofxGrtTextCache();
+
+    /**
+     @brief draws the text with the font at [x,y], matching ofTrueTypeFont::drawString
+     @return returns true if the text was drawn, false if the font is not loaded
+    */
+    bool drawString( const ofTrueTypeFont *font, const std::string &text, const float x, const float y );
+
+    /**
+     @brief returns the bounding box of the text drawn at [0,0], matching ofTrueTypeFont::getStringBoundingBox
+    */
+    ofRectangle getStringBoundingBox( const ofTrueTypeFont *font, const std::string &text );
+
+    /**
+     @brief removes all the cached meshes, this should be called if a font is reloaded
+    */
+    void clear();
+
+    size_t getSize() const { return entries.size(); }
+
+protected:
+    struct Entry{
+        ofMesh mesh;
+        ofRectangle bounds;
+        uint64_t lastUsedFrame;
+    };
+    typedef std::pair< const ofTrueTypeFont*, std::string > Key;
+
+    Entry* getEntry( const ofTrueTypeFont *font, const std::string &text );
+
+    size_t maxSize;
+    std::map< Key, Entry > entries;
+};
@@ -1,16 +1,103 @@
 #include "ofxGrtTimeseriesPlot.h"
+#include "ofxGrtPlotGroup.h"
 #include <algorithm>
 
 using namespace GRT;
+
+//The raw sample values are streamed as a one component vertex position (ofVbo only issues a draw call when it has vertex data),
+//the shader reads the value from position.x and rebuilds the screen position from gl_VertexID
+static const std::string retainedVertexShader = R"(
+#version 150
+uniform mat4 modelViewProjectionMatrix;
+uniform int firstVertex;
+uniform float xStart;
+uniform float xStep;
+uniform float plotHeight;
+uniform vec2 valueRange;
+uniform int constrainValues;
+in vec4 position;
+void main(){
+    float value = position.x;
+    float x = xStart + float(gl_VertexID - firstVertex) * xStep;
+    float t = (value - valueRange.x) / (valueRange.y - valueRange.x);
+    if( constrainValues != 0 ) t = clamp( t, 0.0, 1.0 );
+    gl_Position = modelViewProjectionMatrix * vec4( x, plotHeight * (1.0 - t), 0.0, 1.0 );
+}
+)";
+
+static const std::string retainedFragmentShader = R"(
+#version 150
+uniform vec4 lineColor;
+out vec4 outputColor;
+void main(){
+    outputColor = lineColor;
+}
+)";
+
+//Adds 10% to each side of the range so the plot sits nicely in the graph, or a tiny value if the range is empty so it can still be mapped
+static void padRange( float &minValue, float &maxValue ){
+    const float range = maxValue - minValue;
+    if( range != 0 ){
+        minValue -= range * 0.1;
+        maxValue += range * 0.1;
+    }else maxValue += 1.0e-10;
+}
+
+//Writes the runs of the ring mirror into the vertex buffer of the retained vbo
+struct ofxGrtVboMirrorWriter{
+    ofxGrtVboMirrorWriter( ofBufferObject &buffer ) : buffer( buffer ) {}
+    void write( const size_t offset, const unsigned int count, const float *data ){
+        buffer.updateData( offset*sizeof(float), count*sizeof(float), data );
+    }
+    ofBufferObject &buffer;
+};
+
+//All plots share one retained shader, it is compiled the first time a plot is drawn in retained mode
+static ofShader& getRetainedShader(){
+    static ofShader shader;
+    static bool initialized = false;
+    if( !initialized ){
+        initialized = true;
+        shader.setupShaderFromSource( GL_VERTEX_SHADER, retainedVertexShader );
+        shader.setupShaderFromSource( GL_FRAGMENT_SHADER, retainedFragmentShader );
+        shader.bindDefaults();
+        shader.linkProgram();
+    }
+    return shader;
+}
     
 ofxGrtTimeseriesPlot::ofxGrtTimeseriesPlot(){
+    group = NULL;
     config = ofxGrtSettings::GetInstance().get();
     plotTitle = "";
     font = &config.get()->fontNormal;
     initialized = false;
+    numChannels = 0;
+    timeseriesLength = 0;
+    bufferHead = 0;
+    lastLabelId = 0;
+    labelTable.assign( 1, "" );
+    classSpanChannel = -1;
+    retainedRendering = false;
+    vboLength = 0;
+    vboChannels = 0;
+    vboPendingSamples = 0;
+    decimation = false;
+    historyEnabled = false;
+    historyViewLength = 0;
+    numTimestamps = 0;
+    timeWindow = 0;
+    historyViewOffset = 0;
+    scrubbing = false;
+    scrubFrame = 0;
     lockRanges = false;
     linkRanges = false;
     dynamicScale = false;
+    statisticsEnabled = false;
+    statisticsLowerQuantile = 0.01f;
+    statisticsUpperQuantile = 0.99f;
+    drawStatistics = false;
+    robustScale = false;
     drawOrderInverted = false;
     globalMin =  std::numeric_limits<float>::max();
     globalMax =  -std::numeric_limits<float>::max();
@@ -19,6 +106,8 @@ ofxGrtTimeseriesPlot::ofxGrtTimeseriesPlot(){
     drawPlotTitle = true;
     drawPlotValues = true;
     drawGrid = true;    
+    valueTextRefreshRate = 10;
+    valueTextUpdateTime = 0;
     textColor = config->activeTextColor;
     backgroundColor = config->backgroundColor;
     gridColor = config->gridColor;
@@ -32,6 +121,13 @@ ofxGrtTimeseriesPlot::ofxGrtTimeseriesPlot(){
 }
 
 ofxGrtTimeseriesPlot::~ofxGrtTimeseriesPlot(){
+    //Leave the group so it does not keep a pointer to this plot, the group locks this plot's mutex so it must not be held here
+    ofxGrtPlotGroup *group = NULL;
+    {
+        std::unique_lock<std::mutex> lock( mtx );
+        group = this->group;
+    }
+    if( group ) group->removePlot( this );
 }
 
 bool ofxGrtTimeseriesPlot::setup( const unsigned int timeseriesLength, const unsigned int numChannels, const std::string title, const ofTrueTypeFont *font ){
@@ -44,6 +140,7 @@ bool ofxGrtTimeseriesPlot::setup( const unsigned int timeseriesLength, const uns
     dataBuffer.clear();
     highlightBuffer.clear();
     labelBuffer.clear();
+    timestampBuffer.clear();
 
     if( timeseriesLength == 0 || numChannels == 0 ) return false;
 
@@ -53,15 +150,33 @@ bool ofxGrtTimeseriesPlot::setup( const unsigned int timeseriesLength, const uns
     this->plotTitle = title;
     if( font ) this->font = font;
 
-    dataBuffer.resize(timeseriesLength, vector<float>(numChannels,-1));
-    highlightBuffer.resize(timeseriesLength, 0);
-    labelBuffer.resize(timeseriesLength, "");
-
-    //Fill the buffer with empty values
-    for(unsigned int i=0; i<timeseriesLength; i++) {
-        dataBuffer.push_back(vector<float>(numChannels,-1));
-        highlightBuffer.push_back(0);
-        labelBuffer.push_back("");
+    //Fill the buffer with empty values, the buffer is always full so the head is also the oldest sample
+    dataBuffer.setup(dataBuffer.getFormat(), numChannels, timeseriesLength, -1);
+    highlightBuffer.assign(timeseriesLength, 0);
+    labelBuffer.assign(timeseriesLength, 0);
+    timestampBuffer.assign(timeseriesLength, 0);
+    clearLabelTable();
+    bufferHead = 0;
+    channelExtrema.resize(numChannels);
+    channelEnvelopes.resize(numChannels);
+    channelStatistics.resize(numChannels);
+    rebuildChannelSummaries();
+    if( ingestGate.getIsOpen() ){
+        ingestGate.close();
+        if( ingestQueue.setup( ingestQueue.getCapacity(), numChannels, ingestQueue.getOverflowPolicy() ) ) ingestGate.open();
+    }
+    if( snapshotGate.getIsOpen() ){
+        snapshotGate.close();
+        snapshot.setup( timeseriesLength );
+        snapshotGate.open();
+    }
+    if( historyEnabled ){
+        historyEnabled = history.setup( numChannels, timeseriesLength, history.getNumLevels(), history.getReductionFactor() );
+    }
+    if( recorder.isOpen() && recorder.getNumChannels() != numChannels ){
+        errorLog << __GRT_LOG__ << " The number of channels has changed, closing the recording " << recorder.getFilename() << endl;
+        recorder.close();
+        scrubbing = false;
     }
 
     lockRanges = false;
@@ -71,11 +186,13 @@ bool ofxGrtTimeseriesPlot::setup( const unsigned int timeseriesLength, const uns
     globalMax =  -std::numeric_limits<float>::max();
     channelRanges.resize( numChannels, std::pair<float,float>(globalMin,globalMax) );
     channelNames.resize(numChannels,"");
+    valueText.clear();
     
 //    labelPlotcolors
 
     channelVisible.resize(numChannels,true);
     
+    invalidateChrome();
     initialized = true;
     
     labelPlotColors.resize(10);
@@ -151,8 +268,10 @@ bool ofxGrtTimeseriesPlot::setup( const unsigned int timeseriesLength, const uns
 
 void ofxGrtTimeseriesPlot::setAxisTitle(const std::string x, const std::string y)
 {
+    std::unique_lock<std::mutex> lock( mtx );
     xAxisInfo = x;
     yAxisInfo = y;
+    invalidateChrome();
 }
 
 bool ofxGrtTimeseriesPlot::reset(){
@@ -171,9 +290,11 @@ bool ofxGrtTimeseriesPlot::reset(){
     }
 
     //Clear the buffer
-    dataBuffer.setAllValues(vector<float>(numChannels,-1));
-    highlightBuffer.setAllValues(0);
-    labelBuffer.setAllValues("");
+    dataBuffer.fill(-1);
+    std::fill(highlightBuffer.begin(), highlightBuffer.end(), 0);
+    clearLabelTable();
+    bufferHead = 0;
+    rebuildChannelSummaries();
     
     return true;
 }
@@ -277,58 +398,84 @@ bool ofxGrtTimeseriesPlot::setRanges( const vector< GRT::MinMax > &ranges, const
 
 bool ofxGrtTimeseriesPlot::setData( const vector<float> &data ){
 
+    //The lock-free path, the data is copied into the ring when the draw thread applies the snapshot
+    if( snapshotGate.enter() ){
+        const bool result = publishSnapshot( data.data(), (unsigned int)data.size() );
+        snapshotGate.leave();
+        return result;
+    }
+
     std::unique_lock<std::mutex> lock( mtx );
 
-    const unsigned int M = (unsigned int)data.size();
+    return applyData( data.data(), (unsigned int)data.size() );
+}
 
-    if( numChannels != 1 ) return false;
-    if( M != timeseriesLength ) return false;
+bool ofxGrtTimeseriesPlot::setData( const vector<double> &data ){
 
-    dataBuffer.reset(); highlightBuffer.reset(); labelBuffer.reset();
+    if( snapshotGate.enter() ){
+        const bool result = publishSnapshot( data.data(), (unsigned int)data.size() );
+        snapshotGate.leave();
+        return result;
+    }
 
-    if( !lockRanges ){
-        globalMin =  std::numeric_limits<float>::max();
-        globalMax =  -std::numeric_limits<float>::max();
-        for(size_t i=0; i<channelRanges.size(); i++){
-            channelRanges[i].first = globalMin;
-            channelRanges[i].second = globalMax;
-        }
+    std::unique_lock<std::mutex> lock( mtx );
+
+    return applyData( data.data(), (unsigned int)data.size() );
+}
+
+bool ofxGrtTimeseriesPlot::setLockFreeData( const bool enabled ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    //Disable the lock-free path and wait for any setData in progress to finish before the snapshot is reallocated
+    snapshotGate.close();
+    if( !enabled ) return true;
+
+    if( !initialized ){
+        errorLog << __GRT_LOG__ << " The plot must be setup before lock-free data can be enabled!" << endl;
+        return false;
     }
-    
-    for(size_t i=0; i<M; i++){
-        dataBuffer(i)[0] = data[i];
 
-        //Check the min and max values
-        if( !lockRanges ){
-            //Update the global min/max
-            if( data[i] < globalMin ){ globalMin = data[i]; }
-            else if( data[i] > globalMax ){ globalMax = data[i]; }
+    snapshot.setup( timeseriesLength );
+    snapshotGate.open();
 
-            //Update the channel min/max
-            for(size_t j=0; j<channelRanges.size(); j++){
-                if( data[i] < channelRanges[j].first ){ channelRanges[j].first = data[i]; }
-                else if( data[i] > channelRanges[j].second ){ channelRanges[j].second = data[i]; }
-            }
-        }
+    return true;
+}
+
+template< class T >
+bool ofxGrtTimeseriesPlot::publishSnapshot( const T *data, const unsigned int size ){
+
+    if( size != snapshot.getFrameSize() ) return false;
+
+    float *frame = snapshot.getWriteFrame();
+    for(unsigned int i=0; i<size; i++){
+        frame[i] = (float)data[i];
     }
+    snapshot.publish();
 
     return true;
 }
 
-bool ofxGrtTimeseriesPlot::setData( const vector<double> &data ){
+void ofxGrtTimeseriesPlot::applySnapshot(){
 
-    std::unique_lock<std::mutex> lock( mtx );
+    if( !snapshotGate.getIsOpen() || !snapshot.acquire() ) return;
+
+    applyData( snapshot.getReadFrame(), snapshot.getFrameSize() );
+}
 
-    const unsigned int M = (unsigned int)data.size();
+template< class T >
+bool ofxGrtTimeseriesPlot::applyData( const T *data, const unsigned int M ){
 
     if( numChannels != 1 ) return false;
     if( M != timeseriesLength ) return false;
 
-    dataBuffer.reset(); highlightBuffer.reset(); labelBuffer.reset();
+    bufferHead = 0;
+    std::fill(highlightBuffer.begin(), highlightBuffer.end(), 0);
+    clearLabelTable();
 
     if( !lockRanges ){
-        globalMin =  std::numeric_limits<double>::max();
-        globalMax =  -std::numeric_limits<double>::max();
+        globalMin =  std::numeric_limits<float>::max();
+        globalMax =  -std::numeric_limits<float>::max();
         for(size_t i=0; i<channelRanges.size(); i++){
             channelRanges[i].first = globalMin;
             channelRanges[i].second = globalMax;
@@ -336,23 +483,25 @@ bool ofxGrtTimeseriesPlot::setData( const vector<double> &data ){
     }
     
     for(unsigned int i=0; i<M; i++){
-        dataBuffer(i)[0] = data[i];
-        highlightBuffer[i] = 0;
+        const float value = (float)data[i];
+        dataBuffer.set( 0, i, value );
 
         //Check the min and max values
         if( !lockRanges ){
             //Update the global min/max
-            if( data[i] < globalMin ){ globalMin = data[i]; }
-            else if( data[i] > globalMax ){ globalMax = data[i]; }
+            if( value < globalMin ){ globalMin = value; }
+            else if( value > globalMax ){ globalMax = value; }
 
             //Update the channel min/max
             for(size_t j=0; j<channelRanges.size(); j++){
-                if( data[i] < channelRanges[j].first ){ channelRanges[j].first = data[i]; }
-                else if( data[i] > channelRanges[j].second ){ channelRanges[j].second = data[i]; }
+                if( value < channelRanges[j].first ){ channelRanges[j].first = value; }
+                else if( value > channelRanges[j].second ){ channelRanges[j].second = value; }
             }
         }
     }
 
+    rebuildChannelSummaries();
+
     return true;
 }
     
@@ -411,7 +560,9 @@ bool ofxGrtTimeseriesPlot::setData( const vector< vector<float> > &data, const b
 
     std::unique_lock<std::mutex> lock( mtx );
 
-    dataBuffer.reset(); highlightBuffer.reset(); labelBuffer.reset();
+    bufferHead = 0;
+    std::fill(highlightBuffer.begin(), highlightBuffer.end(), 0);
+    clearLabelTable();
 
     if( !lockRanges ){
         globalMin =  std::numeric_limits<float>::max();
@@ -436,7 +587,7 @@ bool ofxGrtTimeseriesPlot::setData( const vector< vector<float> > &data, const b
                 return false;
             }
             for(unsigned int j=0; j<timeseriesLength; j++){
-                dataBuffer(j)[i] = data[i][j];
+                dataBuffer.set( (unsigned int)i, j, data[i][j] );
 
                 //Check the min and max values
                 if( !lockRanges ){
@@ -451,6 +602,8 @@ bool ofxGrtTimeseriesPlot::setData( const vector< vector<float> > &data, const b
             }       
         }
         
+        rebuildChannelSummaries();
+        
         return true;
     }else{
         //The outer vector (rows) should contain the timeseries data for channel n
@@ -465,8 +618,7 @@ bool ofxGrtTimeseriesPlot::setData( const vector< vector<float> > &data, const b
                 return false;
             }
             for(size_t j=0; j<numChannels; j++){
-                dataBuffer(i)[j] = data[i][j];
-                highlightBuffer[i] = 0;
+                dataBuffer.set( (unsigned int)j, (unsigned int)i, data[i][j] );
 
                 //Check the min and max values
                 if( !lockRanges ){
@@ -481,6 +633,8 @@ bool ofxGrtTimeseriesPlot::setData( const vector< vector<float> > &data, const b
             }
         }
 
+        rebuildChannelSummaries();
+
         return true;
     }
 
@@ -499,7 +653,9 @@ bool ofxGrtTimeseriesPlot::setData( const Matrix<float> &data ){
         return false;
     }
     
-    dataBuffer.reset(); highlightBuffer.reset(); labelBuffer.reset();
+    bufferHead = 0;
+    std::fill(highlightBuffer.begin(), highlightBuffer.end(), 0);
+    clearLabelTable();
 
     if( !lockRanges ){
         globalMin =  std::numeric_limits<float>::max();
@@ -510,10 +666,14 @@ bool ofxGrtTimeseriesPlot::setData( const Matrix<float> &data ){
         }
     }
 
+    if( M > timeseriesLength ){
+        errorLog << __GRT_LOG__ << " The number of rows in the data is larger than the timeseries length of the graph!" << endl;
+        return false;
+    }
+
     for(unsigned int i=0; i<M; i++){
         for(unsigned int j=0; j<numChannels; j++){
-            dataBuffer(i)[j] = data[i][j];
-            highlightBuffer[i] = 0;
+            dataBuffer.set( j, i, data[i][j] );
 
             //Check the min and max values
             if( !lockRanges ){
@@ -528,6 +688,8 @@ bool ofxGrtTimeseriesPlot::setData( const Matrix<float> &data ){
         }
     }
     
+    rebuildChannelSummaries();
+    
     return true;
 }
 
@@ -542,7 +704,9 @@ bool ofxGrtTimeseriesPlot::setData( const Matrix<double> &data ){
         errorLog << __GRT_LOG__ << " The number of dimensions in the data does not match the number of dimensions in the graph!" << endl;
         return false;
     }
-    dataBuffer.reset(); highlightBuffer.reset(); labelBuffer.reset();
+    bufferHead = 0;
+    std::fill(highlightBuffer.begin(), highlightBuffer.end(), 0);
+    clearLabelTable();
 
     if( !lockRanges ){
         globalMin =  std::numeric_limits<double>::max();
@@ -553,10 +717,14 @@ bool ofxGrtTimeseriesPlot::setData( const Matrix<double> &data ){
         }
     }
     
+    if( M > timeseriesLength ){
+        errorLog << __GRT_LOG__ << " The number of rows in the data is larger than the timeseries length of the graph!" << endl;
+        return false;
+    }
+
     for(unsigned int i=0; i<M; i++){
         for(unsigned int j=0; j<numChannels; j++){
-            dataBuffer(i)[j] = data[i][j];
-            highlightBuffer[i] = 0;
+            dataBuffer.set( j, i, data[i][j] );
 
             //Check the min and max values
             if( !lockRanges ){
@@ -571,6 +739,8 @@ bool ofxGrtTimeseriesPlot::setData( const Matrix<double> &data ){
         }
     }
     
+    rebuildChannelSummaries();
+    
     return true;
 }
 
@@ -593,6 +763,7 @@ bool ofxGrtTimeseriesPlot::setNamesForChannels(const vector<std::string> names)
     if(names.size()==channelNames.size())
     {
         channelNames=names;
+        valueText.clear();
         return true;
     }
     return false;
@@ -612,14 +783,54 @@ bool ofxGrtTimeseriesPlot::update(){
     if( !initialized ) return false;
     
     //Repeat the previos value
-    dataBuffer.push_back( dataBuffer[timeseriesLength-1] );
-    highlightBuffer.push_back( highlightBuffer[timeseriesLength - 1] );
-    labelBuffer.push_back( labelBuffer[timeseriesLength - 1] );
+    const unsigned int prevIndex = getRingIndex( timeseriesLength-1 );
+    for(unsigned int j=0; j<numChannels; j++){
+        const float value = dataBuffer.get( j, prevIndex );
+        setRingValue( j, bufferHead, value );
+        channelExtrema[j].push( value );
+        if( decimation ) channelEnvelopes[j].write( bufferHead, value );
+        if( historyEnabled ) history.write( j, &value, 1, 1 );
+        if( recorder.isOpen() ) recorder.write( j, &value, 1, 1 );
+    }
+    if( historyEnabled ) history.advance( 1 );
+    if( recorder.isOpen() ) recorder.advance( 1 );
+    highlightBuffer[ bufferHead ] = highlightBuffer[ prevIndex ];
+    labelBuffer[ bufferHead ] = labelBuffer[ prevIndex ];
+    setTimestamp( bufferHead, ofGetElapsedTimeMillis() );
+    highlightSpans.push( getHighlightKey( bufferHead ) );
+    if( classSpanChannel >= 0 ) classSpans.push( (int)dataBuffer.get( classSpanChannel, bufferHead ) );
+    bufferHead = getRingIndex( 1 );
+    if( vboPendingSamples < timeseriesLength ) vboPendingSamples++;
 
     return true;
 }
 
-bool ofxGrtTimeseriesPlot::update( const vector<float> &data, bool highlight, std::string label ){
+bool ofxGrtTimeseriesPlot::update( const vector<float> &data, bool highlight, const std::string &label ){
+    return update( ofGetElapsedTimeMillis(), data, highlight, label );
+}
+
+bool ofxGrtTimeseriesPlot::update( const vector<double> &data, bool highlight, const std::string &label ){
+    return update( ofGetElapsedTimeMillis(), data, highlight, label );
+}
+
+bool ofxGrtTimeseriesPlot::update( const vector<double> &data, const std::string &label )
+{
+    return update( ofGetElapsedTimeMillis(), data, false, label );
+}
+
+bool ofxGrtTimeseriesPlot::update( const vector<float> &data, const std::string &label )
+{
+    return update( ofGetElapsedTimeMillis(), data, false, label );
+}
+
+bool ofxGrtTimeseriesPlot::update( const uint64_t timestamp, const vector<float> &data, bool highlight, const std::string &label ){
+
+    //The lock-free path, the sample is added to the ring when the draw thread drains the queue
+    if( ingestGate.enter() ){
+        const bool result = data.size() == ingestQueue.getFrameSize() && ingestQueue.push( &data[0], highlight, label, timestamp );
+        ingestGate.leave();
+        return result;
+    }
 
     std::unique_lock<std::mutex> lock( mtx );
 
@@ -629,227 +840,1067 @@ bool ofxGrtTimeseriesPlot::update( const vector<float> &data, bool highlight, st
     if( !initialized || N != numChannels ) return false;
     
     //Add the new value to the buffer
-    dataBuffer.push_back( data );
-    highlightBuffer.push_back( highlight );
-    labelBuffer.push_back( label );
-    
-    //Check the min and max values
-    if( !lockRanges ){
-        for(unsigned int j=0; j<channelRanges.size(); j++){
-            //Update the global min/max
-            if( data[j] < globalMin ){ globalMin = data[j]; }
-            else if( data[j] > globalMax ){ globalMax = data[j]; }
-
-            //Update the channel min/max
-            if( data[j] < channelRanges[j].first ){ channelRanges[j].first = data[j]; }
-            else if( data[j] > channelRanges[j].second ){ channelRanges[j].second = data[j]; }
-        }
-    }
+    pushSample( &data[0], highlight, label, timestamp );
     
     return true;
     
 }
 
-bool ofxGrtTimeseriesPlot::update( const vector<double> &data, bool highlight, std::string label ){
+bool ofxGrtTimeseriesPlot::update( const uint64_t timestamp, const vector<double> &data, bool highlight, const std::string &label ){
 
+    //The doubles are converted into the producer scratch buffer, rather than a temporary vector for each sample.
+    //The scratch is only used by the producer thread when the ingest queue is enabled and under the lock otherwise
     const size_t N = data.size();
-    vector<float> tmp(N);
-    for(size_t i=0; i<N; i++){
-        tmp[i] = data[i];
+
+    if( ingestGate.enter() ){
+        bool result = false;
+        if( N == ingestQueue.getFrameSize() ){
+            if( ingestScratch.size() != N ) ingestScratch.resize( N );
+            for(size_t i=0; i<N; i++){
+                ingestScratch[i] = (float)data[i];
+            }
+            result = ingestQueue.push( &ingestScratch[0], highlight, label, timestamp );
+        }
+        ingestGate.leave();
+        return result;
     }
-    
-    return update( tmp, highlight, label );
-}
 
-bool ofxGrtTimeseriesPlot::update( const vector<float> &data, std::string label )
-{
     std::unique_lock<std::mutex> lock( mtx );
-    
-    const unsigned int N = data.size();
-    
-    //If the buffer has not been initialised then return false, otherwise update the buffer
+
     if( !initialized || N != numChannels ) return false;
-    
-    //Add the new value to the buffer
-    dataBuffer.push_back( data );
-    highlightBuffer.push_back( false );
-    labelBuffer.push_back( label );
-    
+
+    if( ingestScratch.size() != N ) ingestScratch.resize( N );
+    for(size_t i=0; i<N; i++){
+        ingestScratch[i] = (float)data[i];
+    }
+    pushSample( &ingestScratch[0], highlight, label, timestamp );
+
+    return true;
+}
+
+void ofxGrtTimeseriesPlot::pushSample( const float *data, const bool highlight, const std::string &label, const uint64_t timestamp ){
+
+    //Write the new sample into the head slot of each channel ring, then advance the head
+    for(unsigned int j=0; j<numChannels; j++){
+        setRingValue( j, bufferHead, data[j] );
+        channelExtrema[j].push( data[j] );
+        if( decimation ) channelEnvelopes[j].write( bufferHead, data[j] );
+        if( historyEnabled ) history.write( j, data+j, 1, 1 );
+        if( recorder.isOpen() ) recorder.write( j, data+j, 1, 1 );
+    }
+    if( historyEnabled ) history.advance( 1 );
+    if( recorder.isOpen() ) recorder.advance( 1 );
+    highlightBuffer[ bufferHead ] = highlight;
+    labelBuffer[ bufferHead ] = internLabel( label );
+    setTimestamp( bufferHead, timestamp );
+    highlightSpans.push( getHighlightKey( bufferHead ) );
+    if( classSpanChannel >= 0 ) classSpans.push( (int)data[ classSpanChannel ] );
+    bufferHead = getRingIndex( 1 );
+    if( vboPendingSamples < timeseriesLength ) vboPendingSamples++;
+
     //Check the min and max values
     if( !lockRanges ){
-        for(unsigned int j=0; j<channelRanges.size(); j++){
+        for(unsigned int j=0; j<numChannels; j++){
             //Update the global min/max
             if( data[j] < globalMin ){ globalMin = data[j]; }
             else if( data[j] > globalMax ){ globalMax = data[j]; }
-            
+
             //Update the channel min/max
             if( data[j] < channelRanges[j].first ){ channelRanges[j].first = data[j]; }
             else if( data[j] > channelRanges[j].second ){ channelRanges[j].second = data[j]; }
         }
     }
-    
-    return true;
 }
 
-bool ofxGrtTimeseriesPlot::update( const vector<double> &data, std::string label )
-{
-    const size_t N = data.size();
-    vector<float> tmp(N);
-    for(size_t i=0; i<N; i++){
-        tmp[i] = data[i];
+bool ofxGrtTimeseriesPlot::appendFrames( const float *interleaved, const size_t numFrames, const bool highlight, const std::string &label ){
+
+    if( interleaved == NULL ) return false;
+
+    const uint64_t timestamp = ofGetElapsedTimeMillis();
+
+    if( ingestGate.enter() ){
+        const unsigned int frameSize = ingestQueue.getFrameSize();
+        bool result = true;
+        for(size_t i=0; i<numFrames; i++){
+            if( !ingestQueue.push( interleaved + i*frameSize, highlight, label, timestamp ) ) result = false;
+        }
+        ingestGate.leave();
+        return result;
     }
-    
-    return update( tmp, label );
-    
-}
-    
-bool ofxGrtTimeseriesPlot::draw( int x, int y, int w, int h ){
+
     std::unique_lock<std::mutex> lock( mtx );
-    
+
     if( !initialized ) return false;
-    
-    float minY = 0;
-    float maxY = 0;
-    
-    if( dynamicScale ){
-        globalMin =  std::numeric_limits<double>::max();
-        globalMax =  -std::numeric_limits<double>::max();
-        for(size_t i=0; i<channelRanges.size(); i++){
-            channelRanges[i].first = globalMin;
-            channelRanges[i].second = globalMax;
-        }
-        
-        for(unsigned int i=0; i<timeseriesLength; i++){
-            for(unsigned int j=0; j<numChannels; j++){
-                //Update the global min/max
-                if( dataBuffer[i][j] < globalMin ){ globalMin = dataBuffer[i][j]; }
-                else if( dataBuffer[i][j] > globalMax ){ globalMax = dataBuffer[i][j]; }
-                
-                //Update the channel min/max
-                if( dataBuffer[i][j] < channelRanges[j].first ){ channelRanges[j].first = dataBuffer[i][j]; }
-                else if( dataBuffer[i][j] > channelRanges[j].second ){ channelRanges[j].second = dataBuffer[i][j]; }
-            }
-        }
-        
-        //Add a small percentage to the min/max values so the plot sits nicely in the graph
-        for(unsigned int j=0; j<numChannels; j++){
-            float range = channelRanges[j].first - channelRanges[j].second;
-            if( range != 0 ){
-                range = range * 0.1;
-                channelRanges[j].first -= range;
-                channelRanges[j].second += range;
+    if( numFrames == 0 ) return true;
+
+    for(unsigned int j=0; j<numChannels; j++){
+        writeChannelFrames( j, interleaved + j, numChannels, numFrames );
+    }
+    finishFrames( numFrames, highlight, label, timestamp );
+
+    return true;
+}
+
+bool ofxGrtTimeseriesPlot::appendFrames( const float * const *channels, const size_t numFrames, const bool highlight, const std::string &label ){
+
+    if( channels == NULL ) return false;
+
+    const uint64_t timestamp = ofGetElapsedTimeMillis();
+
+    if( ingestGate.enter() ){
+        //The queue stores interleaved frames, so gather each frame into the producers scratch buffer first
+        const unsigned int frameSize = ingestQueue.getFrameSize();
+        if( ingestScratch.size() != frameSize ) ingestScratch.resize( frameSize );
+        bool result = true;
+        for(size_t i=0; i<numFrames; i++){
+            for(unsigned int j=0; j<frameSize; j++){
+                ingestScratch[j] = channels[j][i];
             }
-            
+            if( !ingestQueue.push( &ingestScratch[0], highlight, label, timestamp ) ) result = false;
         }
+        ingestGate.leave();
+        return result;
     }
-    
-    //Bad things happen if the min and max values are the NAN or the same (as we can't scale the plots correctly)
-    //So add a small value to the max if needed
-    if( grt_isnan(globalMin) || grt_isinf(globalMin) ){
-        globalMin = 0;
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( !initialized ) return false;
+    if( numFrames == 0 ) return true;
+
+    for(unsigned int j=0; j<numChannels; j++){
+        writeChannelFrames( j, channels[j], 1, numFrames );
     }
-    if( grt_isnan(globalMax) || grt_isinf(globalMax) ){
-        globalMax = 1;
+    finishFrames( numFrames, highlight, label, timestamp );
+
+    return true;
+}
+
+void ofxGrtTimeseriesPlot::writeChannelFrames( const unsigned int channel, const float *source, const size_t stride, const size_t numFrames ){
+
+    const unsigned int L = timeseriesLength;
+    float *channelData = dataBuffer.getFloatData( channel );
+    float blockMin = std::numeric_limits<float>::max();
+    float blockMax = -std::numeric_limits<float>::max();
+
+    //The history and recording keep every frame, even if the block is longer than the ring
+    if( historyEnabled ) history.write( channel, source, stride, numFrames );
+    if( recorder.isOpen() ) recorder.write( channel, source, stride, numFrames );
+
+    //If the block is longer than the ring, only the last L frames end up in the ring but all the frames count towards the ranges
+    const size_t numSkipped = numFrames > L ? numFrames - L : 0;
+    if( !lockRanges ){
+        for(size_t i=0; i<numSkipped; i++){
+            blockMin = std::min( blockMin, source[i*stride] );
+            blockMax = std::max( blockMax, source[i*stride] );
+        }
     }
-    if( globalMin == globalMax ){
-        globalMax += 1.0e-10;
+
+    const unsigned int start = getRingIndex( (unsigned int)(numSkipped % L) );
+    unsigned int index = start;
+    for(size_t i=numSkipped; i<numFrames; i++){
+        const float value = source[i*stride];
+        if( channelData ){
+            if( statisticsEnabled ) channelStatistics[ channel ].push( value, channelData[ index ] );
+            channelData[ index ] = value;
+        }else setRingValue( channel, index, value );
+        blockMin = std::min( blockMin, value );
+        blockMax = std::max( blockMax, value );
+        channelExtrema[ channel ].push( value );
+        if( decimation ) channelEnvelopes[ channel ].write( index, value );
+        if( (int)channel == classSpanChannel ) classSpans.push( (int)value );
+        if( ++index == L ) index = 0;
     }
-    if( !linkRanges ){
-        for(size_t i=0; i<channelRanges.size(); i++){
-            if( grt_isnan(channelRanges[i].first) || grt_isinf(channelRanges[i].first) ){
-                channelRanges[i].first = 0;
-            }
-            if( grt_isnan(channelRanges[i].second) || grt_isinf(channelRanges[i].second) ){
-                channelRanges[i].second = 0;
-            }
-            if( channelRanges[i].first == channelRanges[i].second ){
-                channelRanges[i].second += 1.0e-10;
-            }
-        }
+
+    //The block min/max is tracked in the same pass that writes the ring, so the block is only read once
+    if( !lockRanges ){
+        if( blockMin < channelRanges[ channel ].first ){ channelRanges[ channel ].first = blockMin; }
+        if( blockMax > channelRanges[ channel ].second ){ channelRanges[ channel ].second = blockMax; }
+        if( blockMin < globalMin ){ globalMin = blockMin; }
+        if( blockMax > globalMax ){ globalMax = blockMax; }
     }
-    
-    if (!insetPlotByInfoMarginX) {
-        x -= config->info_margin;
-        w += config->info_margin;
+}
+
+void ofxGrtTimeseriesPlot::finishFrames( const size_t numFrames, const bool highlight, const std::string &label, const uint64_t timestamp ){
+
+    const unsigned int L = timeseriesLength;
+    const unsigned int numWritten = (unsigned int)std::min( numFrames, (size_t)L );
+    const unsigned short labelId = internLabel( label );
+    unsigned int index = getRingIndex( (unsigned int)((numFrames - numWritten) % L) );
+
+    //The block only has one timestamp, so its frames are spread evenly between the previous sample and the block time.
+    //The previous sample is the newest one before the block, which is still in the slot behind the head
+    const uint64_t previous = timestampBuffer[ getRingIndex( L-1 ) ];
+    const uint64_t blockTime = std::max( timestamp, previous );
+    const bool hasPrevious = numTimestamps > 0;
+    for(unsigned int i=0; i<numWritten; i++){
+        highlightBuffer[ index ] = highlight;
+        labelBuffer[ index ] = labelId;
+        setTimestamp( index, hasPrevious ? previous + (blockTime - previous) * (i+1) / numWritten : blockTime );
+        if( ++index == L ) index = 0;
     }
+    bufferHead = index;
+    if( historyEnabled ) history.advance( numFrames );
+    if( recorder.isOpen() ) recorder.advance( numFrames );
+    highlightSpans.push( highlight ? labelId + 1 : 0, numWritten );
+    vboPendingSamples = std::min( vboPendingSamples + numWritten, L );
+}
 
-    if (!insetPlotByInfoMarginY) {
-        h += config->info_margin;
+bool ofxGrtTimeseriesPlot::setIngestQueue( const unsigned int capacity, const ofxGrtIngestQueue::OverflowPolicy policy ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    //Disable the queue and wait for any push in progress to finish before it is reallocated, update then falls back to the locked path
+    ingestGate.close();
+
+    if( capacity == 0 ){
+        ingestQueue.setup( 0, 0, policy );
+        return true;
     }
 
-    ofPushMatrix();
-    ofEnableAlphaBlending();
-    ofTranslate(x, y);
-    
-    //Draw the background
-    ofFill();
-    ofSetColor(backgroundColor);
-    ofDrawRectangle(config->info_margin,0,w-config->info_margin,h-config->info_margin);
-    
-    //Draw the grid if required
-    if( drawGrid ){
-        
-        ofSetColor(gridColor);
-        unsigned int numVLines = 20;
-        unsigned int numHLines = 10;
-        
-        //Draw the horizontal lines
-        for(unsigned int i=0; i<=numHLines; i++){
-            float xStart = config->info_margin;
-            float xEnd = w;
-            float yStart = ofMap(i,0,numHLines,0,h-config->info_margin);
-            float yEnd = yStart;
-            ofDrawLine(xStart,yStart,xEnd,yEnd);
-        }
-        
-        //Draw the vertical lines
-        for(unsigned int i=0; i<=numVLines; i++){
-            float xStart = ofMap(i,0,numVLines,config->info_margin,w);
-            float xEnd = xStart;
-            float yStart = 0;
-            float yEnd = h-config->info_margin;
-            ofDrawLine(xStart,yStart,xEnd,yEnd);
-        }
+    if( !initialized ){
+        errorLog << __GRT_LOG__ << " The plot must be setup before the ingest queue can be enabled!" << endl;
+        return false;
+    }
+
+    if( !ingestQueue.setup( capacity, numChannels, policy ) ) return false;
+    ingestGate.open();
+
+    return true;
+}
+
+bool ofxGrtTimeseriesPlot::setHistory( const unsigned int numLevels, const unsigned int reductionFactor ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    historyEnabled = false;
+    historyViewLength = 0;
+    historyViewOffset = 0;
+
+    if( numLevels == 0 ){
+        history.setup( 0, 0, 0 );
+        return true;
+    }
+
+    if( !initialized ){
+        errorLog << __GRT_LOG__ << " The plot must be setup before the history can be enabled!" << endl;
+        return false;
+    }
+
+    if( reductionFactor < 2 ){
+        errorLog << __GRT_LOG__ << " The reduction factor must be at least 2!" << endl;
+        return false;
+    }
+
+    historyEnabled = history.setup( numChannels, timeseriesLength, numLevels, reductionFactor );
+
+    return historyEnabled;
+}
+
+bool ofxGrtTimeseriesPlot::setHistoryView( const unsigned long long viewLength, const unsigned long long viewOffset ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( !historyEnabled && viewLength > 0 ){
+        errorLog << __GRT_LOG__ << " The history must be enabled before it can be viewed!" << endl;
+        return false;
+    }
+
+    historyViewLength = viewLength;
+    historyViewOffset = viewOffset;
+
+    return true;
+}
+
+bool ofxGrtTimeseriesPlot::setTimeWindow( const uint64_t timeWindow ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    this->timeWindow = timeWindow;
+
+    return true;
+}
+
+unsigned int ofxGrtTimeseriesPlot::getFirstVisibleSample( uint64_t &windowStart ) const{
+
+    windowStart = 0;
+    if( timeWindow == 0 ) return 0;
+
+    const unsigned int L = timeseriesLength;
+    if( numTimestamps == 0 ) return L;
+
+    const uint64_t newest = timestampBuffer[ getRingIndex( L-1 ) ];
+    windowStart = newest > timeWindow ? newest - timeWindow : 0;
+
+    //The timestamps never decrease from the oldest slot to the newest, so the first sample in the window can be found with a binary search over the ring
+    const unsigned int oldest = L - numTimestamps;
+    unsigned int low = oldest;
+    unsigned int high = L-1;
+    while( low < high ){
+        const unsigned int mid = low + (high - low) / 2;
+        if( timestampBuffer[ getRingIndex( mid ) ] < windowStart ) low = mid + 1;
+        else high = mid;
+    }
+
+    //Keep the sample before the window (if there is one) so the lines reach the left edge of the plot, getSampleValue interpolates it to windowStart
+    return low > oldest ? low - 1 : low;
+}
+
+bool ofxGrtTimeseriesPlot::setRecording( const std::string &filename ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    scrubbing = false;
+    recorder.close();
+
+    if( filename == "" ) return true;
+
+    if( !initialized ){
+        errorLog << __GRT_LOG__ << " The plot must be setup before a recording can be opened!" << endl;
+        return false;
+    }
+
+    return recorder.open( filename, numChannels );
+}
+
+bool ofxGrtTimeseriesPlot::scrubRecording( const unsigned long long firstFrame ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( !recorder.isOpen() ){
+        errorLog << __GRT_LOG__ << " There is no recording to scrub!" << endl;
+        return false;
+    }
+
+    scrubbing = true;
+    scrubFrame = firstFrame;
+
+    return true;
+}
+
+void ofxGrtTimeseriesPlot::drainIngestQueue(){
+
+    if( !ingestGate.getIsOpen() ) return;
+
+    while( ingestQueue.pop( ingestFrame ) ){
+        ingestLabel.assign( ingestFrame.label );
+        pushSample( &ingestFrame.data[0], ingestFrame.highlight, ingestLabel, ingestFrame.timestamp );
+    }
+}
+
+void ofxGrtTimeseriesPlot::rebuildChannelSummaries(){
+
+    //The ring has been overwritten, so the vbo also needs a full upload
+    vboPendingSamples = timeseriesLength;
+
+    rebuildHighlightSpans();
+    classSpanChannel = -1;
+    history.clear();
+
+    //The samples in the ring have no timestamps, so they are not drawn in the time window until new samples arrive
+    std::fill( timestampBuffer.begin(), timestampBuffer.end(), 0 );
+    numTimestamps = 0;
+
+    for(unsigned int j=0; j<numChannels; j++){
+        const ofxGrtSampleBuffer::Channel channelData = getChannelBuffer( j );
+        channelExtrema[j].setup( timeseriesLength );
+        for(unsigned int i=0; i<timeseriesLength; i++){
+            channelExtrema[j].push( channelData[ getRingIndex(i) ] );
+        }
+        if( decimation ){
+            channelEnvelopes[j].setup( timeseriesLength );
+            channelEnvelopes[j].rebuild( channelData );
+        }
+        if( statisticsEnabled ) rebuildChannelStatistics( j );
+    }
+}
+
+void ofxGrtTimeseriesPlot::rebuildHighlightSpans(){
+
+    highlightSpans.setup( timeseriesLength );
+    for(unsigned int i=0; i<timeseriesLength; i++){
+        highlightSpans.push( getHighlightKey( getRingIndex(i) ) );
+    }
+}
+
+void ofxGrtTimeseriesPlot::rebuildClassSpans( const unsigned int channel ){
+
+    const ofxGrtSampleBuffer::Channel channelData = getChannelBuffer( channel );
+    classSpans.setup( timeseriesLength );
+    for(unsigned int i=0; i<timeseriesLength; i++){
+        classSpans.push( (int)channelData[ getRingIndex(i) ] );
+    }
+    classSpanChannel = channel;
+}
+
+bool ofxGrtTimeseriesPlot::setSampleFormat( const ofxGrtSampleFormat format, const vector< GRT::MinMax > &ranges ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( !initialized ){
+        errorLog << __GRT_LOG__ << " The plot must be setup before the sample format can be set!" << endl;
+        return false;
+    }
+
+    if( !ranges.empty() && ranges.size() != numChannels ){
+        errorLog << __GRT_LOG__ << " The number of ranges does not match the number of channels!" << endl;
+        return false;
+    }
+
+    //Decode the current samples so they can be stored again in the new format
+    const unsigned int L = timeseriesLength;
+    vector< float > samples( (size_t)numChannels*L );
+    for(unsigned int j=0; j<numChannels; j++){
+        dataBuffer.decode( j, 0, L, &samples[ j*L ] );
+    }
+
+    dataBuffer.setup( format, numChannels, L, 0 );
+    for(unsigned int j=0; j<numChannels; j++){
+        float scale = 1;
+        float offset = 0;
+        const float range = ranges.empty() ? 0 : (float)(ranges[j].maxValue - ranges[j].minValue);
+        if( range > 0 ){
+            if( format == OFXGRT_SAMPLE_INT16 ){
+                scale = range / 65535.0f;
+                offset = ranges[j].minValue + 32768.0f * scale;
+            }else if( format == OFXGRT_SAMPLE_UINT8 ){
+                scale = range / 255.0f;
+                offset = ranges[j].minValue;
+            }
+        }
+        dataBuffer.setScale( j, scale, offset );
+        for(unsigned int i=0; i<L; i++){
+            dataBuffer.set( j, i, samples[ j*L + i ] );
+        }
+    }
+
+    //The stored values may have been quantized, so the summaries are rebuilt from the new buffer (the history keeps the original values)
+    vboPendingSamples = L;
+    classSpanChannel = -1;
+    for(unsigned int j=0; j<numChannels; j++){
+        const ofxGrtSampleBuffer::Channel channelData = getChannelBuffer( j );
+        channelExtrema[j].setup( L );
+        for(unsigned int i=0; i<L; i++){
+            channelExtrema[j].push( channelData[ getRingIndex(i) ] );
+        }
+        if( decimation ) channelEnvelopes[j].rebuild( channelData );
+        if( statisticsEnabled ) rebuildChannelStatistics( j );
+    }
+
+    return true;
+}
+
+bool ofxGrtTimeseriesPlot::setDecimation( const bool decimation ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    //The envelopes are not maintained while decimation is disabled, so they need to be rebuilt before they can be used
+    if( decimation && !this->decimation ){
+        for(unsigned int j=0; j<numChannels; j++){
+            channelEnvelopes[j].setup( timeseriesLength );
+            channelEnvelopes[j].rebuild( getChannelBuffer( j ) );
+        }
+    }
+    this->decimation = decimation;
+    return true;
+}
+
+void ofxGrtTimeseriesPlot::updateDynamicRanges(){
+
+    globalMin =  std::numeric_limits<float>::max();
+    globalMax =  -std::numeric_limits<float>::max();
+
+    for(unsigned int j=0; j<numChannels; j++){
+        channelRanges[j].first = channelExtrema[j].getMin();
+        channelRanges[j].second = channelExtrema[j].getMax();
+
+        //Update the global min/max
+        if( channelRanges[j].first < globalMin ){ globalMin = channelRanges[j].first; }
+        if( channelRanges[j].second > globalMax ){ globalMax = channelRanges[j].second; }
+
+        //Add a small percentage to the min/max values so the plot sits nicely in the graph
+        padRange( channelRanges[j].first, channelRanges[j].second );
+    }
+}
+
+void ofxGrtTimeseriesPlot::updateRobustRanges(){
+
+    globalMin =  std::numeric_limits<float>::max();
+    globalMax =  -std::numeric_limits<float>::max();
+
+    for(unsigned int j=0; j<numChannels; j++){
+        //The quantiles ignore the rare outliers that would otherwise stretch the min/max of the whole window
+        channelRanges[j].first = channelStatistics[j].getLowerQuantile();
+        channelRanges[j].second = channelStatistics[j].getUpperQuantile();
+
+        if( channelRanges[j].first < globalMin ){ globalMin = channelRanges[j].first; }
+        if( channelRanges[j].second > globalMax ){ globalMax = channelRanges[j].second; }
+
+        padRange( channelRanges[j].first, channelRanges[j].second );
+    }
+}
+
+void ofxGrtTimeseriesPlot::rebuildChannelStatistics( const unsigned int channel ){
+
+    const ofxGrtSampleBuffer::Channel channelData = getChannelBuffer( channel );
+    channelStatistics[ channel ].setup( timeseriesLength, statisticsLowerQuantile, statisticsUpperQuantile );
+    for(unsigned int i=0; i<timeseriesLength; i++){
+        channelStatistics[ channel ].add( channelData[ getRingIndex(i) ] );
+    }
+}
+
+bool ofxGrtTimeseriesPlot::setStatistics( const bool enabled, const float lowerQuantile, const float upperQuantile ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( lowerQuantile < 0 || upperQuantile > 1 || lowerQuantile >= upperQuantile ){
+        errorLog << __GRT_LOG__ << " The quantiles must be in the range [0 1] and the lower quantile must be less than the upper quantile!" << endl;
+        return false;
+    }
+
+    statisticsEnabled = enabled;
+    statisticsLowerQuantile = lowerQuantile;
+    statisticsUpperQuantile = upperQuantile;
+
+    //The statistics are only maintained while they are enabled, so they are rebuilt from the ring when they are turned on
+    if( statisticsEnabled && initialized ){
+        for(unsigned int j=0; j<numChannels; j++){
+            rebuildChannelStatistics( j );
+        }
+    }
+
+    return true;
+}
+
+bool ofxGrtTimeseriesPlot::setDrawStatistics( const bool drawStatistics ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( drawStatistics && !statisticsEnabled ){
+        errorLog << __GRT_LOG__ << " The statistics must be enabled before they can be drawn!" << endl;
+        return false;
+    }
+
+    this->drawStatistics = drawStatistics;
+
+    return true;
+}
+
+bool ofxGrtTimeseriesPlot::setRobustScale( const bool robustScale ){
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( robustScale && !statisticsEnabled ){
+        errorLog << __GRT_LOG__ << " The statistics must be enabled before the plot can be scaled to their quantiles!" << endl;
+        return false;
+    }
+
+    this->robustScale = robustScale;
+
+    return true;
+}
+
+ofxGrtStreamingStats::Summary ofxGrtTimeseriesPlot::getChannelStatistics( const unsigned int channel ) const{
+
+    std::unique_lock<std::mutex> lock( mtx );
+
+    if( !statisticsEnabled || channel >= numChannels ) return ofxGrtStreamingStats().getSummary();
+
+    return channelStatistics[ channel ].getSummary();
+}
+
+void ofxGrtTimeseriesPlot::drawStatisticsOverlay( const float plotWidth, const float plotHeight ){
+
+    //Each visible channel gets a band one standard deviation either side of its mean, with the mean drawn as a line
+    ofFill();
+    for(unsigned int n=0; n<numChannels; n++){
+        const unsigned int channelIndex = drawOrderInverted ? numChannels-1-n : n;
+        if( !channelVisible[ channelIndex ] ) continue;
+
+        const float minY = linkRanges ? globalMin : channelRanges[ channelIndex ].first;
+        const float maxY = linkRanges ? globalMax : channelRanges[ channelIndex ].second;
+        const ofxGrtStreamingStats::Summary summary = channelStatistics[ channelIndex ].getSummary();
+        const float meanY = ofMap( summary.mean, minY, maxY, plotHeight, 0, true );
+        const float upperY = ofMap( summary.mean + summary.standardDeviation, minY, maxY, plotHeight, 0, true );
+        const float lowerY = ofMap( summary.mean - summary.standardDeviation, minY, maxY, plotHeight, 0, true );
+        const ofColor &color = colors[ channelIndex ];
+
+        ofSetColor( color[0], color[1], color[2], 40 );
+        ofDrawRectangle( config->info_margin, upperY, plotWidth, lowerY-upperY );
+        ofSetColor( color[0], color[1], color[2], 160 );
+        ofDrawLine( config->info_margin, meanY, config->info_margin+plotWidth, meanY );
+    }
+}
+
+void ofxGrtTimeseriesPlot::uploadPendingSamples(){
+
+    const unsigned int L = timeseriesLength;
+    if( L == 0 || numChannels == 0 ) return;
+
+    //The vbo is only reallocated if the size of the plot has changed, every other upload refreshes the existing buffer in place
+    if( vboLength != L || vboChannels != numChannels ){
+        ofxGrtRingMirror::build( dataBuffer, vboScratch );
+        vbo.setVertexData( &vboScratch[0], 1, (int)vboScratch.size(), GL_DYNAMIC_DRAW, sizeof(float) );
+        vboLength = L;
+        vboChannels = numChannels;
+        vboPendingSamples = 0;
+        return;
+    }
+
+    if( vboPendingSamples == 0 ) return;
+
+    ofxGrtVboMirrorWriter writer( vbo.getVertexBuffer() );
+    ofxGrtRingMirror::update( dataBuffer, bufferHead, vboPendingSamples, vboScratch, writer );
+    vboPendingSamples = 0;
+}
+
+bool ofxGrtTimeseriesPlot::drawRetainedTimeseries( const float plotWidth, const float plotHeight ){
+
+    ofShader &shader = getRetainedShader();
+    if( !shader.isLoaded() ) return false;
+
+    uploadPendingSamples();
+
+    shader.begin();
+    shader.setUniform1f( "xStart", config->info_margin );
+    shader.setUniform1f( "xStep", plotWidth / (float)timeseriesLength );
+    shader.setUniform1f( "plotHeight", plotHeight );
+    shader.setUniform1i( "constrainValues", constrainValuesToGraph ? 1 : 0 );
+    for(unsigned int n=0; n<numChannels; n++){
+        const unsigned int channelIndex = drawOrderInverted ? numChannels-1-n : n;
+        if( !channelVisible[ channelIndex ] ) continue;
+
+        const float minY = linkRanges ? globalMin : channelRanges[ channelIndex ].first;
+        const float maxY = linkRanges ? globalMax : channelRanges[ channelIndex ].second;
+        const ofColor &color = colors[ channelIndex ];
+
+        //Starting at the head of the first copy gives the samples from oldest to newest as one contiguous strip
+        const int firstVertex = ofxGrtRingMirror::getFirstVertex( channelIndex, timeseriesLength, bufferHead );
+        shader.setUniform1i( "firstVertex", firstVertex );
+        shader.setUniform2f( "valueRange", minY, maxY );
+        shader.setUniform4f( "lineColor", color.r/255.0f, color.g/255.0f, color.b/255.0f, color.a/255.0f );
+        vbo.draw( GL_LINE_STRIP, firstVertex, timeseriesLength );
+    }
+    shader.end();
+
+    return true;
+}
+
+bool ofxGrtTimeseriesPlot::drawTimedTimeseries( const float plotWidth, const float plotHeight ){
+
+    if( timeWindow == 0 ) return false;
+
+    uint64_t windowStart = 0;
+    const unsigned int firstSample = getFirstVisibleSample( windowStart );
+
+    for(unsigned int n=0; n<numChannels; n++){
+        const unsigned int channelIndex = drawOrderInverted ? numChannels-1-n : n;
+        if( !channelVisible[ channelIndex ] ) continue;
+
+        const float minY = linkRanges ? globalMin : channelRanges[ channelIndex ].first;
+        const float maxY = linkRanges ? globalMax : channelRanges[ channelIndex ].second;
+        ofSetColor( colors[ channelIndex ][0],colors[ channelIndex ][1],colors[ channelIndex ][2] );
+
+        const ofxGrtSampleBuffer::Channel channelData = getChannelBuffer( channelIndex );
+        ofBeginShape();
+        for(unsigned int i=firstSample; i<timeseriesLength; i++){
+            ofVertex( config->info_margin + getSampleX( i, plotWidth, windowStart ), ofMap(getSampleValue( channelData, i, windowStart ), minY, maxY, plotHeight, 0, constrainValuesToGraph) );
+        }
+        ofEndShape(false);
+    }
+
+    return true;
+}
+
+bool ofxGrtTimeseriesPlot::drawDecimatedTimeseries( const float plotWidth, const float plotHeight ){
+
+    const unsigned int numColumns = plotWidth > 0 ? (unsigned int)plotWidth : 0;
+    if( !decimation || numColumns == 0 || timeseriesLength < numColumns*2 ) return false;
+
+    const unsigned int L = timeseriesLength;
+    const float xStep = plotWidth / (float)numColumns;
+    float minY = 0;
+    float maxY = 0;
+    float columnMin = 0;
+    float columnMax = 0;
+    float wrapMin = 0;
+    float wrapMax = 0;
+
+    for(unsigned int n=0; n<numChannels; n++){
+        const unsigned int channelIndex = drawOrderInverted ? numChannels-1-n : n;
+        if( !channelVisible[ channelIndex ] ) continue;
+
+        minY = linkRanges ? globalMin : channelRanges[ channelIndex ].first;
+        maxY = linkRanges ? globalMax : channelRanges[ channelIndex ].second;
+        ofSetColor( colors[ channelIndex ][0],colors[ channelIndex ][1],colors[ channelIndex ][2] );
+
+        const ofxGrtSampleBuffer::Channel channelData = getChannelBuffer( channelIndex );
+        const ofxGrtRingEnvelope &envelope = channelEnvelopes[ channelIndex ];
+        float xPos = config->info_margin;
+        ofBeginShape();
+        for(unsigned int c=0; c<numColumns; c++){
+            //Find the samples that fall in this pixel column, splitting the range if it wraps around the end of the ring
+            const unsigned int i0 = (unsigned int)( (unsigned long long)c * L / numColumns );
+            const unsigned int i1 = (unsigned int)( (unsigned long long)(c+1) * L / numColumns );
+            const unsigned int start = getRingIndex( i0 );
+            const unsigned int end = start + (i1 - i0);
+            if( end <= L ){
+                envelope.getRange( channelData, bufferHead, start, end, columnMin, columnMax );
+            }else{
+                envelope.getRange( channelData, bufferHead, start, L, columnMin, columnMax );
+                envelope.getRange( channelData, bufferHead, 0, end - L, wrapMin, wrapMax );
+                columnMin = std::min( columnMin, wrapMin );
+                columnMax = std::max( columnMax, wrapMax );
+            }
+
+            //Alternate the direction of each column so the strip does not zig-zag back across the envelope
+            const float yMin = ofMap(columnMin, minY, maxY, plotHeight, 0, constrainValuesToGraph);
+            const float yMax = ofMap(columnMax, minY, maxY, plotHeight, 0, constrainValuesToGraph);
+            ofVertex( xPos, c % 2 == 0 ? yMin : yMax );
+            ofVertex( xPos, c % 2 == 0 ? yMax : yMin );
+            xPos += xStep;
+        }
+        ofEndShape(false);
+    }
+
+    return true;
+}
+
+bool ofxGrtTimeseriesPlot::drawRecordedTimeseries( const float plotWidth, const float plotHeight ){
+
+    if( !scrubbing || !recorder.isOpen() ) return false;
+
+    const unsigned long long numFrames = recorder.getNumFrames();
+    if( scrubFrame >= numFrames ) return true;
+    const unsigned int numDrawn = (unsigned int)std::min( (unsigned long long)timeseriesLength, numFrames - scrubFrame );
+
+    //The frames are read straight from the mapping, they are interleaved so each channel is a strided walk
+    const float *frames = recorder.getFrame( scrubFrame );
+    const float xStep = plotWidth / (float)timeseriesLength;
+    float minY = 0;
+    float maxY = 0;
+
+    for(unsigned int n=0; n<numChannels; n++){
+        const unsigned int channelIndex = drawOrderInverted ? numChannels-1-n : n;
+        if( !channelVisible[ channelIndex ] ) continue;
+
+        minY = linkRanges ? globalMin : channelRanges[ channelIndex ].first;
+        maxY = linkRanges ? globalMax : channelRanges[ channelIndex ].second;
+
+        //The dynamic ranges only cover the live ring, so scale the recording to the frames being viewed instead
+        if( dynamicScale ){
+            minY = std::numeric_limits<float>::max();
+            maxY = -std::numeric_limits<float>::max();
+            for(unsigned int i=0; i<numDrawn; i++){
+                minY = std::min( minY, frames[ i*numChannels + channelIndex ] );
+                maxY = std::max( maxY, frames[ i*numChannels + channelIndex ] );
+            }
+            padRange( minY, maxY );
+        }
+        ofSetColor( colors[ channelIndex ][0],colors[ channelIndex ][1],colors[ channelIndex ][2] );
+
+        float xPos = config->info_margin;
+        ofBeginShape();
+        for(unsigned int i=0; i<numDrawn; i++){
+            ofVertex( xPos, ofMap(frames[ i*numChannels + channelIndex ], minY, maxY, plotHeight, 0, constrainValuesToGraph) );
+            xPos += xStep;
+        }
+        ofEndShape(false);
+    }
+
+    return true;
+}
+
+bool ofxGrtTimeseriesPlot::drawHistoryTimeseries( const float plotWidth, const float plotHeight ){
+
+    if( !historyEnabled || historyViewLength == 0 || plotWidth <= 0 ) return false;
+
+    //The window is anchored to the newest sample, so a fixed offset keeps the view still while a zero offset follows the live data
+    const unsigned long long numSamples = history.getNumSamples();
+    const unsigned long long end = numSamples > historyViewOffset ? numSamples - historyViewOffset : 0;
+    const unsigned long long start = end > historyViewLength ? end - historyViewLength : 0;
+    const float xScale = plotWidth / (float)historyViewLength;
+    const unsigned int maxBuckets = (unsigned int)plotWidth;
+    ofxGrtHistoryPyramid::View view;
+    float minY = 0;
+    float maxY = 0;
+
+    for(unsigned int n=0; n<numChannels; n++){
+        const unsigned int channelIndex = drawOrderInverted ? numChannels-1-n : n;
+        if( !channelVisible[ channelIndex ] ) continue;
+        if( !history.getWindow( channelIndex, start, end, maxBuckets, historyBuckets, view ) ) continue;
+
+        minY = linkRanges ? globalMin : channelRanges[ channelIndex ].first;
+        maxY = linkRanges ? globalMax : channelRanges[ channelIndex ].second;
+
+        //The dynamic ranges only cover the live ring, so scale the history to the window being viewed instead
+        if( dynamicScale ){
+            minY = std::numeric_limits<float>::max();
+            maxY = -std::numeric_limits<float>::max();
+            for(size_t i=0; i<historyBuckets.size(); i++){
+                minY = std::min( minY, historyBuckets[i].min );
+                maxY = std::max( maxY, historyBuckets[i].max );
+            }
+            padRange( minY, maxY );
+        }
+        ofSetColor( colors[ channelIndex ][0],colors[ channelIndex ][1],colors[ channelIndex ][2] );
+
+        //Alternate the direction of each bucket so the strip does not zig-zag back across the envelope
+        float xPos = config->info_margin + (float)((long long)view.firstSample - (long long)start) * xScale;
+        const float xStep = view.samplesPerBucket * xScale;
+        ofBeginShape();
+        for(size_t i=0; i<historyBuckets.size(); i++){
+            const float yMin = ofMap(historyBuckets[i].min, minY, maxY, plotHeight, 0, constrainValuesToGraph);
+            const float yMax = ofMap(historyBuckets[i].max, minY, maxY, plotHeight, 0, constrainValuesToGraph);
+            ofVertex( xPos, i % 2 == 0 ? yMin : yMax );
+            ofVertex( xPos, i % 2 == 0 ? yMax : yMin );
+            xPos += xStep;
+        }
+        ofEndShape(false);
+    }
+
+    return true;
+}
+
+unsigned short ofxGrtTimeseriesPlot::internLabel( const std::string &label ){
+
+    if( label.empty() ) return 0;
+    if( labelTable[ lastLabelId ] == label ) return lastLabelId;
+
+    std::unordered_map< std::string, unsigned short >::const_iterator iter = labelTableIndex.find( label );
+    if( iter != labelTableIndex.end() ){
+        lastLabelId = iter->second;
+        return lastLabelId;
+    }
+
+    //If the table is full, drop the labels that are no longer referenced by any slot in the ring
+    if( labelTable.size() > std::numeric_limits<unsigned short>::max() ){
+        vector< unsigned short > remap( labelTable.size(), 0 );
+        vector< std::string > usedLabels( 1, "" );
+        for(unsigned int i=0; i<timeseriesLength; i++){
+            const unsigned short oldId = labelBuffer[i];
+            if( oldId != 0 && remap[ oldId ] == 0 ){
+                remap[ oldId ] = (unsigned short)usedLabels.size();
+                usedLabels.push_back( labelTable[ oldId ] );
+            }
+            labelBuffer[i] = remap[ oldId ];
+        }
+        labelTable.swap( usedLabels );
+        labelTableIndex.clear();
+        for(size_t i=1; i<labelTable.size(); i++){
+            labelTableIndex[ labelTable[i] ] = (unsigned short)i;
+        }
+        lastLabelId = 0;
+        rebuildHighlightSpans();
+
+        if( labelTable.size() > std::numeric_limits<unsigned short>::max() ){
+            errorLog << __GRT_LOG__ << " The label table is full, the label " << label << " will not be drawn!" << endl;
+            return 0;
+        }
+    }
+
+    lastLabelId = (unsigned short)labelTable.size();
+    labelTable.push_back( label );
+    labelTableIndex[ label ] = lastLabelId;
+    return lastLabelId;
+}
+
+void ofxGrtTimeseriesPlot::clearLabelTable(){
+
+    std::fill(labelBuffer.begin(), labelBuffer.end(), 0);
+    labelTable.assign( 1, "" );
+    labelTableIndex.clear();
+    lastLabelId = 0;
+}
+
+void ofxGrtTimeseriesPlot::drawPlotValueText( const int textX, int textY ){
+
+    //Only rebuild the text when the refresh interval has elapsed, otherwise the cached glyph meshes for the last text are reused
+    const uint64_t now = ofGetElapsedTimeMillis();
+    const bool refresh = valueText.size() != numChannels || valueTextRefreshRate <= 0 || now - valueTextUpdateTime >= 1000.0f / valueTextRefreshRate;
+    if( refresh ){
+        std::stringstream info;
+        info.precision( 2 );
+        valueText.resize( numChannels );
+        for(unsigned int n=0; n<numChannels; n++){
+            const float minY = linkRanges ? globalMin : channelRanges[n].first;
+            const float maxY = linkRanges ? globalMax : channelRanges[n].second;
+            info.str("");
+            info << "[" << n+1 << "]: " << channelNames[n] << " ";
+            info << getLatestValue(n) << " [" << minY << " " << maxY << "]" << endl;
+            valueText[n] = info.str();
+        }
+        valueTextUpdateTime = now;
+    }
+
+    for(unsigned int n=0; n<numChannels; n++){
+        if( channelVisible[n] ){
+            ofSetColor(colors[n][0],colors[n][1],colors[n][2]);
+            const ofRectangle bounds = textCache.getStringBoundingBox(font, valueText[n]);
+            textCache.drawString(font, valueText[n], textX, textY);
+            textY += bounds.height + 5;
+        }
+    }
+}
+
+void ofxGrtTimeseriesPlot::drawChrome( const float w, const float h ){
+    
+    //Draw the background
+    ofFill();
+    ofSetColor(backgroundColor);
+    ofDrawRectangle(config->info_margin,0,w-config->info_margin,h-config->info_margin);
+    
+    //Draw the grid if required
+    if( drawGrid ){
+        
+        ofSetColor(gridColor);
+        unsigned int numVLines = 20;
+        unsigned int numHLines = 10;
+        
+        //Draw the horizontal lines
+        for(unsigned int i=0; i<=numHLines; i++){
+            float xStart = config->info_margin;
+            float xEnd = w;
+            float yStart = ofMap(i,0,numHLines,0,h-config->info_margin);
+            float yEnd = yStart;
+            ofDrawLine(xStart,yStart,xEnd,yEnd);
+        }
+        
+        //Draw the vertical lines
+        for(unsigned int i=0; i<=numVLines; i++){
+            float xStart = ofMap(i,0,numVLines,config->info_margin,w);
+            float xEnd = xStart;
+            float yStart = 0;
+            float yEnd = h-config->info_margin;
+            ofDrawLine(xStart,yStart,xEnd,yEnd);
+        }
+    }
+    
+    //Draw the axis lines
+    ofSetColor(axisColor);
+    ofDrawLine(-5+config->info_margin,h-config->info_margin,w+5,h-config->info_margin); //X Axis
+    ofDrawLine(0+config->info_margin,-5,0+config->info_margin,h+5-config->info_margin); //Y Axis
+    
+    ofSetColor(textColor[0],textColor[1],textColor[2]);
+    //Draw axis info
+    if(font)
+    {
+
+        const float posX = -5+config->info_margin;
+        const float posY = h;
+        
+        textCache.drawString(font, xAxisInfo, posX, posY);
+        
+        ofPushMatrix();
+        {
+            ofRotateZ(-90.0f);
+            
+            const ofRectangle bounds = textCache.getStringBoundingBox(font, yAxisInfo);
+            const float posY = -float(h)+bounds.width-config->info_margin;
+            const float posX = bounds.height;
+            textCache.drawString(font, yAxisInfo, posY, posX);
+        }
+        ofPopMatrix();
+        
+    }
+    
+    //draw axis ticks
+    {
+        ofSetColor(axisColor);
+        unsigned int numVTicks = 20;
+        unsigned int numHTicks = 10;
+        
+        //Draw the horizontal lines
+        for(unsigned int i=0; i<=numHTicks; i++){
+            float xStart = -config->axisTicksSize+config->info_margin;
+            float xEnd = config->axisTicksSize+config->info_margin;
+            float yStart = ofMap(i,0,numHTicks,0,h-config->info_margin);
+            float yEnd = yStart;
+            ofDrawLine(xStart,yStart,xEnd,yEnd);
+            
+        }
+        
+        //Draw the vertical lines
+        for(unsigned int i=0; i<=numVTicks; i++){
+            float xStart = ofMap(i,0,numVTicks,config->info_margin,w);
+            float xEnd = xStart;
+            float yStart = h-config->info_margin;
+            float yEnd = h+5-config->info_margin;
+            ofDrawLine(xStart,yStart,xEnd,yEnd);
+        }
+    }
+}
+
+void ofxGrtTimeseriesPlot::drawLabeledChrome( const float w, const float h ){
+    
+    //Draw the background
+    ofFill();
+    ofSetColor(backgroundColor[0],backgroundColor[1],backgroundColor[2]);
+    ofDrawRectangle(config->info_margin,config->info_margin,w-config->info_margin,h-config->info_margin*2);
+    
+    //Draw the grid if required
+    if( drawGrid ){
+        
+        ofSetColor(gridColor[0],gridColor[1],gridColor[2],gridColor[3]);
+        unsigned int numVLines = 20;
+        unsigned int numHLines = 10;
+        
+        //Draw the horizontal lines
+        for(unsigned int i=0; i<=numChannels; i++){
+            float xStart = config->info_margin;
+            float xEnd = w;
+            float yStart = ofMap(i,0,numChannels,config->info_margin,h-config->info_margin);
+            float yEnd = yStart;
+            ofDrawLine(xStart,yStart,xEnd,yEnd);
+        }
+        
+        //Draw the vertical lines
+        for(unsigned int i=0; i<=numVLines; i++){
+            float xStart = ofMap(i,0,numVLines,config->info_margin,w);
+            float xEnd = xStart;
+            float yStart = config->info_margin;
+            float yEnd = h-config->info_margin;
+            ofDrawLine(xStart,yStart,xEnd,yEnd);
+        }
     }
     
     //Draw the axis lines
     ofSetColor(axisColor);
     ofDrawLine(-5+config->info_margin,h-config->info_margin,w+5,h-config->info_margin); //X Axis
-    ofDrawLine(0+config->info_margin,-5,0+config->info_margin,h+5-config->info_margin); //Y Axis
+    ofDrawLine(0+config->info_margin,-5+config->info_margin,0+config->info_margin,h+5-config->info_margin); //Y Axis
     
-    ofSetColor(textColor[0],textColor[1],textColor[2]);
+    ofSetColor(textColor);
     //Draw axis info
     if(font)
     {
-
+        
         const float posX = -5+config->info_margin;
         const float posY = h;
         
-        font->drawString(xAxisInfo, posX, posY);
+        textCache.drawString(font, xAxisInfo, posX, posY);
         
         ofPushMatrix();
         {
-            ofRotateZ(-90.0f);
             
-            const float posY = -float(h)+font->stringWidth(yAxisInfo)-config->info_margin;
-            const float posX = font->stringHeight(yAxisInfo);
-            font->drawString(yAxisInfo, posY, posX);
+            const ofRectangle bounds = textCache.getStringBoundingBox(font, yAxisInfo);
+            const float posY = -float(h)+bounds.width+config->info_margin/2;
+            const float posX = bounds.height;
+            ofRotateZ(-90.0f);
+            textCache.drawString(font, yAxisInfo, posY, posX);
         }
         ofPopMatrix();
-        
     }
     
     //draw axis ticks
     {
-        ofSetColor(axisColor);
+        ofSetColor(gridColor);
         unsigned int numVTicks = 20;
-        unsigned int numHTicks = 10;
+        unsigned int numHTicks = 1;
         
         //Draw the horizontal lines
         for(unsigned int i=0; i<=numHTicks; i++){
             float xStart = -config->axisTicksSize+config->info_margin;
-            float xEnd = config->axisTicksSize+config->info_margin;
-            float yStart = ofMap(i,0,numHTicks,0,h-config->info_margin);
+            float xEnd = 0+config->info_margin;
+            float yStart = ofMap(i,0,numHTicks,config->info_margin,h-config->info_margin);
             float yEnd = yStart;
             ofDrawLine(xStart,yStart,xEnd,yEnd);
             
@@ -860,49 +1911,150 @@ bool ofxGrtTimeseriesPlot::draw( int x, int y, int w, int h ){
             float xStart = ofMap(i,0,numVTicks,config->info_margin,w);
             float xEnd = xStart;
             float yStart = h-config->info_margin;
-            float yEnd = h+5-config->info_margin;
+            float yEnd = h+config->axisTicksSize-config->info_margin;
             ofDrawLine(xStart,yStart,xEnd,yEnd);
         }
     }
+}
+
+float ofxGrtTimeseriesPlot::getChromePadding() const{
+    //The axes, ticks and axis labels extend outside the plot area
+    return config->info_margin + config->axisTicksSize + (font ? font->getLineHeight() : 0);
+}
+
+bool ofxGrtTimeseriesPlot::draw( int x, int y, int w, int h ){
+    std::unique_lock<std::mutex> lock( mtx );
+    return drawPlot( x, y, w, h, NULL );
+}
+
+bool ofxGrtTimeseriesPlot::drawPlot( int x, int y, int w, int h, ofMesh *lineMesh ){
+
+    if( !initialized ) return false;
+
+    applySnapshot();
+    drainIngestQueue();
+
+    //Grow the recording from the draw thread before it fills up, so appending never has to remap the file
+    if( recorder.isOpen() ) recorder.reserveAhead();
+    
+    float minY = 0;
+    float maxY = 0;
+    
+    if( robustScale && statisticsEnabled ){
+        updateRobustRanges();
+    }else if( dynamicScale ){
+        updateDynamicRanges();
+    }
+    
+    //Bad things happen if the min and max values are the NAN or the same (as we can't scale the plots correctly)
+    //So add a small value to the max if needed
+    if( grt_isnan(globalMin) || grt_isinf(globalMin) ){
+        globalMin = 0;
+    }
+    if( grt_isnan(globalMax) || grt_isinf(globalMax) ){
+        globalMax = 1;
+    }
+    if( globalMin == globalMax ){
+        globalMax += 1.0e-10;
+    }
+    if( !linkRanges ){
+        for(size_t i=0; i<channelRanges.size(); i++){
+            if( grt_isnan(channelRanges[i].first) || grt_isinf(channelRanges[i].first) ){
+                channelRanges[i].first = 0;
+            }
+            if( grt_isnan(channelRanges[i].second) || grt_isinf(channelRanges[i].second) ){
+                channelRanges[i].second = 0;
+            }
+            if( channelRanges[i].first == channelRanges[i].second ){
+                channelRanges[i].second += 1.0e-10;
+            }
+        }
+    }
+    
+    if (!insetPlotByInfoMarginX) {
+        x -= config->info_margin;
+        w += config->info_margin;
+    }
+
+    if (!insetPlotByInfoMarginY) {
+        h += config->info_margin;
+    }
+
+    ofPushMatrix();
+    ofEnableAlphaBlending();
+    ofTranslate(x, y);
+    
+    //The background, grid, axes and ticks only change with the size or style of the plot, so they are drawn from a cached layer
+    if( !chromeLayer.isValid( w, h ) ){
+        chromeLayer.begin( w, h, getChromePadding() );
+        drawChrome( w, h );
+        chromeLayer.end();
+    }
+    chromeLayer.draw();
+    ofFill();
     
     //Draw the timeseries
     if( globalMin != globalMax ){
         float xPos = config->info_margin;
         float xStep = (w-config->info_margin) / (float)timeseriesLength;
+        //The history and recording do not store highlights, so they are only drawn for the live view
+        const bool historyView = scrubbing || (historyEnabled && historyViewLength > 0);
+        //Each highlighted span is drawn as one rectangle, with its label (if any) drawn at the start of the span.
+        //The span edges are placed with getSampleX, so they follow the sample timestamps when the time window is set
+        uint64_t windowStart = 0;
+        getFirstVisibleSample( windowStart );
+        const float plotWidth = w-config->info_margin;
+        unsigned int spanStart = 0;
         ofSetColor(32);
-        for(unsigned int i=0; i<highlightBuffer.getNumValuesInBuffer(); i++){
-            if (highlightBuffer[i]) ofDrawRectangle( xPos, 0, xStep, h-config->info_margin );
-            xPos += xStep;
+        for(unsigned int i=0; i<highlightSpans.getNumSpans() && !historyView; i++){
+            const ofxGrtSpanList::Span &span = highlightSpans[i];
+            if( span.key != 0 ){
+                const float spanX = getSampleX( spanStart, plotWidth, windowStart );
+                ofDrawRectangle( xPos + spanX, 0, getSampleX( spanStart+span.length, plotWidth, windowStart ) - spanX, h-config->info_margin );
+            }
+            spanStart += span.length;
         }
-        std::string label = "";
-        xPos = config->info_margin;
+        spanStart = 0;
         ofSetColor(255);
         ofFill();
-        for(unsigned int i=0; i<highlightBuffer.getNumValuesInBuffer(); i++){
-            if (highlightBuffer[i]) {
-                if (labelBuffer[i] != label) {
-                    ofDrawBitmapString(labelBuffer[i], xPos, h-config->info_margin);
-                    label = labelBuffer[i];
-                }
-            } else {
-                label = "";
-            }
-            xPos += xStep;
+        for(unsigned int i=0; i<highlightSpans.getNumSpans() && !historyView; i++){
+            const ofxGrtSpanList::Span &span = highlightSpans[i];
+            if( span.key > 1 ) ofDrawBitmapString(labelTable[span.key-1], xPos + getSampleX( spanStart, plotWidth, windowStart ), h-config->info_margin);
+            spanStart += span.length;
+        }
+        if( drawStatistics && statisticsEnabled && !historyView ){
+            drawStatisticsOverlay( w-config->info_margin, h-config->info_margin );
         }
-        unsigned int index = 0;
         unsigned int channelIndex = 0;
         ofNoFill();
-        for(unsigned int n=0; n<numChannels; n++){
+        bool drawn = drawRecordedTimeseries( w-config->info_margin, h-config->info_margin );
+        if( !drawn ) drawn = historyView && drawHistoryTimeseries( w-config->info_margin, h-config->info_margin );
+        if( !drawn && timeWindow == 0 ) drawn = drawDecimatedTimeseries( w-config->info_margin, h-config->info_margin );
+        if( !drawn && lineMesh != NULL ){
+            appendLiveLines( *lineMesh, x, y, w-config->info_margin, h-config->info_margin );
+            drawn = true;
+        }
+        if( !drawn && timeWindow == 0 && retainedRendering && ofIsGLProgrammableRenderer() ){
+            drawn = drawRetainedTimeseries( w-config->info_margin, h-config->info_margin );
+        }
+        if( !drawn ) drawn = drawTimedTimeseries( w-config->info_margin, h-config->info_margin );
+        for(unsigned int n=0; n<numChannels && !drawn; n++){
             xPos = config->info_margin;
-            index = 0;
             channelIndex = drawOrderInverted ? numChannels-1-n : n;
             if( channelVisible[ channelIndex ] ){
                 minY = linkRanges ? globalMin : channelRanges[ channelIndex ].first;
                 maxY = linkRanges ? globalMax : channelRanges[ channelIndex ].second;
                 ofSetColor( colors[ channelIndex ][0],colors[ channelIndex ][1],colors[ channelIndex ][2] );
+
+                //The ring is drawn as two linear sweeps, [head,end) holds the oldest samples and [0,head) the newest
+                const ofxGrtSampleBuffer::Channel channelData = getChannelBuffer( channelIndex );
                 ofBeginShape();
-                for(unsigned int i=0; i<timeseriesLength; i++){
-                    ofVertex( xPos, ofMap(dataBuffer[i][ channelIndex ], minY, maxY, h-config->info_margin, 0, constrainValuesToGraph) );
+                for(unsigned int i=bufferHead; i<timeseriesLength; i++){
+                    ofVertex( xPos, ofMap(channelData[i], minY, maxY, h-config->info_margin, 0, constrainValuesToGraph) );
+                    xPos += xStep;
+                }
+                for(unsigned int i=0; i<bufferHead; i++){
+                    ofVertex( xPos, ofMap(channelData[i], minY, maxY, h-config->info_margin, 0, constrainValuesToGraph) );
                     xPos += xStep;
                 }
                 ofEndShape(false);
@@ -919,35 +2071,20 @@ bool ofxGrtTimeseriesPlot::draw( int x, int y, int w, int h ){
         if( !font->isLoaded() ) return false;
         
         if( drawInfoText ){
-            ofRectangle bounds = font->getStringBoundingBox(plotTitle, 0, 0);
             int textX = config->info_margin;
             int textY = -config->titleTextSpacer;
 //            int textSpacer = bounds.height + 5;
             
             if( plotTitle != "" && drawPlotTitle ){
                 ofSetColor(textColor);
-                font->drawString( plotTitle, textX, textY );
+                textCache.drawString( font, plotTitle, textX, textY );
                 
 //
             }
             textY += font->getLineHeight();
             
             if( drawPlotValues ){
-                std::stringstream info;
-                info.precision( 2 );
-                for(unsigned int n=0; n<numChannels; n++){
-                    if( channelVisible[n] ){
-                        minY = linkRanges ? globalMin : channelRanges[n].first;
-                        maxY = linkRanges ? globalMax : channelRanges[n].second;
-                        ofSetColor(colors[n][0],colors[n][1],colors[n][2]);
-                        info.str("");
-                        info << "[" << n+1 << "]: " << channelNames[n] << " ";
-                        info << dataBuffer[timeseriesLength-1][n] << " [" << minY << " " << maxY << "]" << endl;
-                        bounds = font->getStringBoundingBox(info.str(), 0, 0);
-                        font->drawString(info.str(),textX,textY);
-                        textY += bounds.height + 5;
-                    }
-                }
+                drawPlotValueText( textX, textY );
             }
         }
     }
@@ -957,43 +2094,51 @@ bool ofxGrtTimeseriesPlot::draw( int x, int y, int w, int h ){
     return true;
 }
 
+void ofxGrtTimeseriesPlot::appendLiveLines( ofMesh &lineMesh, const float x, const float y, const float plotWidth, const float plotHeight ) const{
+
+    uint64_t windowStart = 0;
+    const unsigned int firstSample = getFirstVisibleSample( windowStart );
+    for(unsigned int n=0; n<numChannels; n++){
+        const unsigned int channelIndex = drawOrderInverted ? numChannels-1-n : n;
+        if( !channelVisible[ channelIndex ] ) continue;
+
+        const float minY = linkRanges ? globalMin : channelRanges[ channelIndex ].first;
+        const float maxY = linkRanges ? globalMax : channelRanges[ channelIndex ].second;
+        const ofFloatColor color( colors[ channelIndex ] );
+
+        //Each channel is a run of vertices from oldest to newest, joined by indexed segments so all the channels can share one draw call
+        const ofxGrtSampleBuffer::Channel channelData = getChannelBuffer( channelIndex );
+        const unsigned int firstVertex = (unsigned int)lineMesh.getNumVertices();
+        for(unsigned int i=firstSample; i<timeseriesLength; i++){
+            const float xPos = x + config->info_margin + getSampleX( i, plotWidth, windowStart );
+            lineMesh.addVertex( ofVec3f( xPos, y + ofMap(getSampleValue( channelData, i, windowStart ), minY, maxY, plotHeight, 0, constrainValuesToGraph) ) );
+            lineMesh.addColor( color );
+            if( i > firstSample ){
+                const unsigned int vertex = firstVertex + (i - firstSample);
+                lineMesh.addIndex( vertex - 1 );
+                lineMesh.addIndex( vertex );
+            }
+        }
+    }
+}
+
 bool ofxGrtTimeseriesPlot::drawLabeledGraph( const unsigned int x, const unsigned int y, const unsigned int w, const unsigned int h, const int chanNum){
     
     std::unique_lock<std::mutex> lock( mtx );
     
     if( !initialized ) return false;
+    if( chanNum < 0 || chanNum >= (int)numChannels ) return false;
+
+    applySnapshot();
+    drainIngestQueue();
+
+    //Grow the recording from the draw thread before it fills up, so appending never has to remap the file
+    if( recorder.isOpen() ) recorder.reserveAhead();
     
-    float minY = 0;
-    float maxY = 0;
-    
-    if( dynamicScale ){
-        globalMin =  std::numeric_limits<double>::max();
-        globalMax =  -std::numeric_limits<double>::max();
-        for(size_t i=0; i<channelRanges.size(); i++){
-            channelRanges[i].first = globalMin;
-            channelRanges[i].second = globalMax;
-        }
-        for(unsigned int i=0; i<timeseriesLength; i++){
-            for(unsigned int j=0; j<numChannels; j++){
-                //Update the global min/max
-                if( dataBuffer[i][j] < globalMin ){ globalMin = dataBuffer[i][j]; }
-                else if( dataBuffer[i][j] > globalMax ){ globalMax = dataBuffer[i][j]; }
-                
-                //Update the channel min/max
-                if( dataBuffer[i][j] < channelRanges[j].first ){ channelRanges[j].first = dataBuffer[i][j]; }
-                else if( dataBuffer[i][j] > channelRanges[j].second ){ channelRanges[j].second = dataBuffer[i][j]; }
-            }
-        }
-        
-        //Add a small percentage to the min/max values so the plot sits nicely in the graph
-        for(unsigned int j=0; j<numChannels; j++){
-            float range = channelRanges[j].first - channelRanges[j].second;
-            if( range != 0 ){
-                range = range * 0.1;
-                channelRanges[j].first -= range;
-                channelRanges[j].second += range;
-            }
-        }
+    if( robustScale && statisticsEnabled ){
+        updateRobustRanges();
+    }else if( dynamicScale ){
+        updateDynamicRanges();
     }
     
     //Bad things happen if the min and max values are the NAN or the same (as we can't scale the plots correctly)
@@ -1025,136 +2170,55 @@ bool ofxGrtTimeseriesPlot::drawLabeledGraph( const unsigned int x, const unsigne
     ofEnableAlphaBlending();
     ofTranslate(x, y);
     
-    //Draw the background
-    ofFill();
-    ofSetColor(backgroundColor[0],backgroundColor[1],backgroundColor[2]);
-    ofDrawRectangle(config->info_margin,config->info_margin,w-config->info_margin,h-config->info_margin*2);
-    
-    //Draw the grid if required
-    if( drawGrid ){
-        
-        ofSetColor(gridColor[0],gridColor[1],gridColor[2],gridColor[3]);
-        unsigned int numVLines = 20;
-        unsigned int numHLines = 10;
-        
-        //Draw the horizontal lines
-        for(unsigned int i=0; i<=numChannels; i++){
-            float xStart = config->info_margin;
-            float xEnd = w;
-            float yStart = ofMap(i,0,numChannels,config->info_margin,h-config->info_margin);
-            float yEnd = yStart;
-            ofDrawLine(xStart,yStart,xEnd,yEnd);
-        }
-        
-        //Draw the vertical lines
-        for(unsigned int i=0; i<=numVLines; i++){
-            float xStart = ofMap(i,0,numVLines,config->info_margin,w);
-            float xEnd = xStart;
-            float yStart = config->info_margin;
-            float yEnd = h-config->info_margin;
-            ofDrawLine(xStart,yStart,xEnd,yEnd);
-        }
-    }
-    
-    //Draw the axis lines
-    ofSetColor(axisColor);
-    ofDrawLine(-5+config->info_margin,h-config->info_margin,w+5,h-config->info_margin); //X Axis
-    ofDrawLine(0+config->info_margin,-5+config->info_margin,0+config->info_margin,h+5-config->info_margin); //Y Axis
-    
-    ofSetColor(textColor);
-    //Draw axis info
-    if(font)
-    {
-        
-        const float posX = -5+config->info_margin;
-        const float posY = h;
-        
-        font->drawString(xAxisInfo, posX, posY);
-        
-        ofPushMatrix();
-        {
-            
-            
-            const float posY = -float(h)+font->stringWidth(yAxisInfo)+config->info_margin/2;
-            const float posX = font->stringHeight(yAxisInfo);
-            ofRotateZ(-90.0f);
-            font->drawString(yAxisInfo, posY, posX);
-        }
-        ofPopMatrix();
-    }
-    
-    //draw axis ticks
-    {
-        ofSetColor(gridColor);
-        unsigned int numVTicks = 20;
-        unsigned int numHTicks = 1;
-        
-        //Draw the horizontal lines
-        for(unsigned int i=0; i<=numHTicks; i++){
-            float xStart = -config->axisTicksSize+config->info_margin;
-            float xEnd = 0+config->info_margin;
-            float yStart = ofMap(i,0,numHTicks,config->info_margin,h-config->info_margin);
-            float yEnd = yStart;
-            ofDrawLine(xStart,yStart,xEnd,yEnd);
-            
-        }
-        
-        //Draw the vertical lines
-        for(unsigned int i=0; i<=numVTicks; i++){
-            float xStart = ofMap(i,0,numVTicks,config->info_margin,w);
-            float xEnd = xStart;
-            float yStart = h-config->info_margin;
-            float yEnd = h+config->axisTicksSize-config->info_margin;
-            ofDrawLine(xStart,yStart,xEnd,yEnd);
-        }
+    //The background, grid, axes and ticks only change with the size or style of the plot, so they are drawn from a cached layer
+    if( !labeledChromeLayer.isValid( w, h ) ){
+        labeledChromeLayer.begin( w, h, getChromePadding() );
+        drawLabeledChrome( w, h );
+        labeledChromeLayer.end();
     }
+    labeledChromeLayer.draw();
+    ofFill();
     
     //Draw the timeseries
     if( globalMin != globalMax ){
         float xPos = config->info_margin;
         const float yPos = config->info_margin;
         const float xStep = (w-config->info_margin) / (float)timeseriesLength;
-        ofSetColor(32);
-        
-        vector<string> labels;
-        vector<ofPoint> positions;
-        vector<ofColor> colors;
         
-        for(unsigned int i=0; i<labelBuffer.getNumValuesInBuffer(); i++)
+        //The class spans are maintained as samples are pushed, they only need rebuilding if a different channel is drawn
+        if( classSpanChannel != chanNum ) rebuildClassSpans( chanNum );
+
+        //Draw one rectangle per class span, negative labels are left empty
+        for(unsigned int i=0; i<classSpans.getNumSpans(); i++)
         {
-            const int colorIdx = dataBuffer[i][chanNum];
-            if(colorIdx<0)
-            {
-                ofSetColor(0,0,0,0);
-                ofDrawRectangle( xPos, yPos, xStep, h-config->info_margin*2 );
-            }
-            else
+            const ofxGrtSpanList::Span &span = classSpans[i];
+            if( span.key >= 0 && span.key < (int)labelPlotColors.size() )
             {
-                ofSetColor(labelPlotColors[colorIdx].background);
-                ofDrawRectangle( xPos, yPos, xStep, h-config->info_margin*2 );
-                const int prevIdx = max<int>(0,i-1);
-                if(dataBuffer[i][chanNum]!=dataBuffer[prevIdx][chanNum] || i==0)
-                {
-                    labels.push_back(to_string((int)dataBuffer[i][chanNum]));
-                    positions.push_back(ofPoint(xPos+2, config->info_margin+(h-config->info_margin*2+font->stringHeight(to_string((int)dataBuffer[i][chanNum])))*0.5));
-                    colors.push_back(labelPlotColors[dataBuffer[i][chanNum]].label);
-                }
+                ofSetColor(labelPlotColors[span.key].background);
+                ofDrawRectangle( xPos, yPos, xStep*span.length, h-config->info_margin*2 );
             }
-            
-            xPos += xStep;
+            xPos += xStep*span.length;
         }
         
-        for(int i=0;i<labels.size();i++)
+        //Draw the label text at the start of each span
+        xPos = config->info_margin;
+        for(unsigned int i=0; i<classSpans.getNumSpans(); i++)
         {
-            ofSetColor( colors[i] );
-            if(font)
-                font->drawString(labels[i], positions[i].x,positions[i].y);
-            else
-                ofDrawBitmapString(labels[i], positions[i].x,positions[i].y);
+            const ofxGrtSpanList::Span &span = classSpans[i];
+            if( span.key >= 0 && span.key < (int)labelPlotColors.size() )
+            {
+                if( span.key >= (int)classLabelText.size() ){
+                    for(int k=(int)classLabelText.size(); k<=span.key; k++) classLabelText.push_back( to_string(k) );
+                }
+                const std::string &text = classLabelText[span.key];
+                ofSetColor( labelPlotColors[span.key].label );
+                if(font)
+                    textCache.drawString(font, text, xPos+2, config->info_margin+(h-config->info_margin*2+textCache.getStringBoundingBox(font, text).height)*0.5);
+                else
+                    ofDrawBitmapString(text, xPos+2, config->info_margin+(h-config->info_margin*2)*0.5);
+            }
+            xPos += xStep*span.length;
         }
-        
-        
-        
     }
     
     //Only draw the text if the font has been loaded
@@ -1163,33 +2227,19 @@ bool ofxGrtTimeseriesPlot::drawLabeledGraph( const unsigned int x, const unsigne
         if( !font->isLoaded() ) return false;
         
         if( drawInfoText ){
-            ofRectangle bounds = font->getStringBoundingBox(plotTitle, 0, 0);
+            const ofRectangle bounds = textCache.getStringBoundingBox(font, plotTitle);
             int textX = config->info_margin;
             int textY = bounds.height;
             int textSpacer = bounds.height + 5;
             
             if( plotTitle != "" && drawPlotTitle ){
                 ofSetColor(textColor[0],textColor[1],textColor[2]);
-                font->drawString( plotTitle, textX, textY );
+                textCache.drawString( font, plotTitle, textX, textY );
                 textY += textSpacer;
             }
             
             if( drawPlotValues ){
-                std::stringstream info;
-                info.precision( 2 );
-                for(unsigned int n=0; n<numChannels; n++){
-                    if( channelVisible[n] ){
-                        minY = linkRanges ? globalMin : channelRanges[n].first;
-                        maxY = linkRanges ? globalMax : channelRanges[n].second;
-                        ofSetColor(colors[n][0],colors[n][1],colors[n][2]);
-                        info.str("");
-                        info << "[" << n+1 << "]: " << channelNames[n] << " ";
-                        info << dataBuffer[timeseriesLength-1][n] << " [" << minY << " " << maxY << "]" << endl;
-                        bounds = font->getStringBoundingBox(info.str(), 0, 0);
-                        font->drawString(info.str(),textX,textY);
-                        textY += bounds.height + 5;
-                    }
-                }
+                drawPlotValueText( textX, textY );
             }
         }
     }
@@ -23,7 +23,21 @@
 #include "GRT/GRT.h"
 #include <iostream>
 #include <vector>
+#include <unordered_map>
 #include "ofxGrtSettings.h"
+#include "ofxGrtSlidingExtrema.h"
+#include "ofxGrtRingEnvelope.h"
+#include "ofxGrtIngestQueue.h"
+#include "ofxGrtProducerGate.h"
+#include "ofxGrtSnapshotBuffer.h"
+#include "ofxGrtSpanList.h"
+#include "ofxGrtTextCache.h"
+#include "ofxGrtHistoryPyramid.h"
+#include "ofxGrtRecorder.h"
+#include "ofxGrtCachedLayer.h"
+#include "ofxGrtSampleBuffer.h"
+#include "ofxGrtRingMirror.h"
+#include "ofxGrtStreamingStats.h"
 
 #define INFO_MARGIN 20
 
@@ -35,7 +49,10 @@ struct labelPlotColor
     ofColor label;
 };
 
+class ofxGrtPlotGroup;
+
 class ofxGrtTimeseriesPlot{
+    friend class ofxGrtPlotGroup;
 public:
     ofxGrtTimeseriesPlot();
     ~ofxGrtTimeseriesPlot();
@@ -60,11 +77,12 @@ public:
     
     /**
      @brief updates the plot pushing the input data into the plots internal buffer. The size of the input Vector must match the number of dimensions in the plot.
+     If the ingest queue has been enabled, the data is pushed into the queue without blocking and added to the plot buffer at the start of the next draw.
      @param highlight whether or not to highlight the newly added data point (default false)
      @param label the label associated with the highlight
      @return returns true if the plot was updated successfully, false otherwise
     */
-    bool update( const vector<float> &data, bool highlight = false, std::string label = "" );
+    bool update( const vector<float> &data, bool highlight = false, const std::string &label = "" );
 
     /**
      @brief updates the plot pushing the input data into the plots internal buffer. The size of the input Vector must match the number of dimensions in the plot.
@@ -72,23 +90,152 @@ public:
      @param label the label associated with the highlight
      @return returns true if the plot was updated successfully, false otherwise
      */
-    bool update( const vector<double> &data, bool highlight = false, std::string label = "" );
+    bool update( const vector<double> &data, bool highlight = false, const std::string &label = "" );
 
     /**
      @brief updates the plot pushing the input data into the plots internal buffer. The size of the input Vector must match the number of dimensions in the plot.
      @param label the label associated with the current data
      @return returns true if the plot was updated successfully, false otherwise
      */
-    bool update( const vector<double> &data, std::string label );
+    bool update( const vector<double> &data, const std::string &label );
     
     /**
      @brief updates the plot pushing the input data into the plots internal buffer. The size of the input Vector must match the number of dimensions in the plot.
      @param label the label associated with the current data
      @return returns true if the plot was updated successfully, false otherwise
      */
-    bool update( const vector<float> &data, std::string label );
+    bool update( const vector<float> &data, const std::string &label );
+
+    /**
+     @brief updates the plot with a sample that carries its own timestamp, this should be used for irregularly sampled sources (e.g. OSC messages) together with setTimeWindow.
+     The untimed update calls stamp each sample with ofGetElapsedTimeMillis().
+     @param timestamp: the time of the sample, in the same units as the time window (milliseconds if the plot also uses the untimed update calls).
+     The timestamps should not decrease, a sample that is older than the newest sample in the plot is drawn at the time of the newest sample
+     @param data: the sample, the size of the data must match the number of dimensions in the plot
+     @param highlight: whether or not to highlight the new data point (default false)
+     @param label: the label associated with the highlight
+     @return returns true if the plot was updated successfully, false otherwise
+    */
+    bool update( const uint64_t timestamp, const vector<float> &data, bool highlight = false, const std::string &label = "" );
+    bool update( const uint64_t timestamp, const vector<double> &data, bool highlight = false, const std::string &label = "" );
 
     
+    /**
+     @brief appends a block of samples to the plot in one call. The mutex is taken once for the whole block, the samples are written
+     straight into the ring and the ranges are updated from a single min/max pass over the block.
+     If the ingest queue has been enabled, each frame is pushed into the queue instead.
+     @param interleaved: the samples for each frame stored one after the other, [frame0 channel0, frame0 channel1, ..., frame1 channel0, ...]
+     @param numFrames: the number of frames in the block, the data must contain numFrames*numChannels values
+     @param highlight: whether or not to highlight the new data points (default false)
+     @param label: the label associated with the new data points
+     @return returns true if the plot was updated successfully, false otherwise
+    */
+    bool appendFrames( const float *interleaved, const size_t numFrames, const bool highlight = false, const std::string &label = "" );
+
+    /**
+     @brief appends a block of samples to the plot in one call, with each channel stored in its own array.
+     @param channels: an array of numChannels pointers, each pointing to numFrames samples for that channel
+     @param numFrames: the number of frames in the block
+     @param highlight: whether or not to highlight the new data points (default false)
+     @param label: the label associated with the new data points
+     @return returns true if the plot was updated successfully, false otherwise
+    */
+    bool appendFrames( const float * const *channels, const size_t numFrames, const bool highlight = false, const std::string &label = "" );
+
+    /**
+     @brief enables a lock-free ingest path so the plot can be fed from a sensor or audio thread without ever blocking on the draw thread.
+     Once enabled, the update(data,...) overloads push into a wait-free single-producer/single-consumer queue instead of taking the plot mutex,
+     and the queue is drained into the plot buffer at the start of draw(). Only one thread may call update at a time.
+     The queue can be resized or disabled while the producer is running, this waits for any push in progress to finish before the queue is reallocated.
+     Calling setup again keeps the queue enabled with the new number of channels. Labels longer than ofxGrtIngestQueue::MAX_LABEL_LENGTH are truncated.
+     @param capacity: the maximum number of samples that can be waiting to be drawn, a capacity of 0 disables the queue
+     @param policy: sets what happens to new samples when the queue is full (drop the oldest, drop the newest, or coalesce them into one sample)
+     @return returns true if the queue was setup successfully, false otherwise
+    */
+    bool setIngestQueue( const unsigned int capacity, const ofxGrtIngestQueue::OverflowPolicy policy = ofxGrtIngestQueue::DROP_OLDEST );
+
+    /**
+     @return returns the number of samples that were dropped or coalesced because the ingest queue was full
+    */
+    unsigned long long getNumDroppedSamples() const { return ingestQueue.getNumDroppedFrames(); }
+
+    /**
+     @brief enables a multi-resolution history of every sample added to the plot, so the plot can be scrolled back well past the last timeseriesLength samples.
+     The most recent timeseriesLength samples are kept at full resolution and each level above holds timeseriesLength min/max/mean buckets that each
+     summarize reductionFactor buckets of the level below, so the memory used is fixed at numChannels*timeseriesLength*numLevels buckets. For example,
+     a 1000 sample plot with 10 levels and a reduction factor of 4 keeps over 2.6e8 samples of history per channel in 120KB.
+     The history is cleared by setData and reset, and calling setup again keeps the history enabled with the new plot size.
+     @param numLevels: the number of levels in the history, 0 disables the history
+     @param reductionFactor: the number of buckets from each level that are summarized by one bucket in the level above
+     @return returns true if the history was setup successfully, false otherwise
+    */
+    bool setHistory( const unsigned int numLevels, const unsigned int reductionFactor = 4 );
+
+    /**
+     @brief sets the window of the history drawn by the plot, the window is drawn from the finest level that has at most one bucket per pixel.
+     Zooming changes the viewLength and panning changes the viewOffset, setting the viewLength to 0 returns the plot to the live view of the last timeseriesLength samples
+     @param viewLength: the number of samples shown across the plot, 0 shows the live view
+     @param viewOffset: the number of samples between the newest sample and the end of the window, 0 keeps the window following the newest samples
+     @return returns true if the parameter was update successfully, false otherwise
+    */
+    bool setHistoryView( const unsigned long long viewLength, const unsigned long long viewOffset = 0 );
+
+    /**
+     @brief draws the live view against a fixed time window ending at the newest sample, rather than spacing the samples evenly across the plot.
+     Each sample is drawn at its timestamp, so jittery or bursty sources are not distorted in time. Only the samples in the window are visited, which are found with a binary search over the timestamp ring.
+     The decimated and retained renderers assume evenly spaced samples, so they are not used while the time window is set.
+     @param timeWindow: the length of the window, in the units of the sample timestamps (milliseconds for the untimed update calls), 0 spaces the samples evenly
+     @return returns true if the parameter was updated successfully, false otherwise
+    */
+    bool setTimeWindow( const uint64_t timeWindow );
+
+    uint64_t getTimeWindow() const {
+        std::unique_lock<std::mutex> lock( mtx );
+        return timeWindow;
+    }
+
+    /**
+     @return returns the number of samples that can currently be viewed in the history, this is the largest useful viewLength + viewOffset
+    */
+    unsigned long long getHistoryLength() const {
+        std::unique_lock<std::mutex> lock( mtx );
+        return history.getNumSamples() - history.getOldestSample();
+    }
+
+    /**
+     @brief records every sample added to the plot into a memory-mapped file, so the complete timeseries can be reviewed later without keeping it in memory.
+     Appending a sample copies it into the mapping, so update never waits on disk writes, the file is grown ahead of time by draw. If the file already holds a recording with the same number
+     of channels then new samples are appended to it, and the existing frames can be scrubbed straight away.
+     @param filename: the path of the recording (relative to the data folder), an empty filename closes the current recording
+     @return returns true if the recording was opened (or closed) successfully, false otherwise
+    */
+    bool setRecording( const std::string &filename );
+
+    /**
+     @brief draws timeseriesLength recorded frames starting at firstFrame instead of the live data, recording continues while the plot is scrubbed
+     @param firstFrame: the index of the first recorded frame to draw
+     @return returns true if the parameter was update successfully, false otherwise
+    */
+    bool scrubRecording( const unsigned long long firstFrame );
+
+    /**
+     @brief returns the plot to the live data after scrubRecording
+     @return returns true if the parameter was update successfully, false otherwise
+    */
+    bool stopScrubbing(){
+        std::unique_lock<std::mutex> lock( mtx );
+        scrubbing = false;
+        return true;
+    }
+
+    /**
+     @return returns the number of frames in the recording, 0 if there is no recording
+    */
+    unsigned long long getNumRecordedFrames() const {
+        std::unique_lock<std::mutex> lock( mtx );
+        return recorder.getNumFrames();
+    }
+
     /**
      @brief draws the plot.     
      @return returns true if the plot was drawn successfully, false otherwise
@@ -115,6 +262,17 @@ public:
     */
     bool setData( const vector<float> &data );
 
+    /**
+     @brief enables a lock-free path for setData(vector<float>) and setData(vector<double>) so a single channel plot can be refilled from a real-time thread
+     (e.g. an audio callback) without the risk of blocking on the draw thread. Once enabled, setData writes the data into a triple buffer and publishes it with
+     a single atomic exchange instead of taking the plot mutex, and draw applies the latest published data. The producer never waits and draw never sees
+     partially written data, data published between two draws is replaced by the latest. Only one thread may call setData at a time.
+     This can be called while the producer is running, it waits for any setData in progress to finish before the buffer is reallocated.
+     @param enabled: if true, then setData will publish the data without locking
+     @return returns true if the parameter was updated successfully, false otherwise
+    */
+    bool setLockFreeData( const bool enabled );
+
     /**
      @brief directly fills the plot buffer with the data, this differs from update as instead of update(...) pushing data into the plot buffer, the setData function directly fills
      the entire plot buffer.  This function should only be called if the plot has been setup with a dimensionality of 1 and the size of the input data matches the length of the plot.
@@ -204,6 +362,7 @@ public:
     bool setDrawGrid( const bool drawGrid ){ 
         std::unique_lock<std::mutex> lock( mtx );
         this->drawGrid = drawGrid; 
+        invalidateChrome();
         return true; 
     }
 
@@ -215,6 +374,7 @@ public:
     bool setFont( const ofTrueTypeFont &font ){ 
         std::unique_lock<std::mutex> lock( mtx );
         this->font = &font; 
+        invalidateChrome();
         return this->font->isLoaded(); 
     }
 
@@ -251,6 +411,34 @@ public:
         return true; 
     }
 
+    /**
+     @brief enables running statistics for each channel over the samples in the plot buffer: the mean, variance and RMS (exact, updated in O(1) per sample)
+     and a lower, median and upper quantile (P-Square estimates). The statistics are kept with the buffer, so they cost no extra passes over the data.
+     @param enabled: if true, then the statistics are maintained as samples are added
+     @param lowerQuantile: the probability of the lower quantile, this is used as the lower bound by the robust scale (default 0.01)
+     @param upperQuantile: the probability of the upper quantile, this is used as the upper bound by the robust scale (default 0.99)
+     @return returns true if the parameter was updated successfully, false otherwise
+    */
+    bool setStatistics( const bool enabled, const float lowerQuantile = 0.01f, const float upperQuantile = 0.99f );
+
+    /**
+     @brief controls if a band of one standard deviation either side of the mean (with the mean as a line) is drawn over each channel, the statistics must be enabled
+     @return returns true if the parameter was updated successfully, false otherwise
+    */
+    bool setDrawStatistics( const bool drawStatistics );
+
+    /**
+     @brief controls if the Y axis ranges are scaled to the lower/upper quantile of each channel, rather than the min/max, so a single outlier does not squash the plot.
+     This takes priority over the dynamic scale, the statistics must be enabled
+     @return returns true if the parameter was updated successfully, false otherwise
+    */
+    bool setRobustScale( const bool robustScale );
+
+    /**
+     @brief returns the running statistics of the channel, all the values are 0 if the statistics are not enabled
+    */
+    ofxGrtStreamingStats::Summary getChannelStatistics( const unsigned int channel ) const;
+
     /**
      @brief controls if the plot should render text (plot title,latest values,etc.), if false then no text will be rendered, if true then the text rendered will depend on the state of the other drawText variables (i.e. drawPlotTitle, drawPlotValues)
      @param drawInfoText: if true, then the plot will render the info text
@@ -284,6 +472,20 @@ public:
         return true; 
     }
 
+    /**
+     @brief sets how many times per second the plot values text is refreshed. The values change with every sample, so refreshing them less often keeps
+     them readable and lets the cached glyph meshes be reused between frames
+     @param valueTextRefreshRate: the refresh rate in Hz, if 0 then the text will be refreshed every time the plot is drawn
+     @return returns true if the parameter was update successfully, false otherwise
+    */
+    bool setValueTextRefreshRate( const float valueTextRefreshRate ){
+        std::unique_lock<std::mutex> lock( mtx );
+        if( valueTextRefreshRate < 0 ) return false;
+        this->valueTextRefreshRate = valueTextRefreshRate;
+        valueText.clear();
+        return true;
+    }
+
     /**
      @brief sets the colors used for each channel
      @return returns true if the parameter was update successfully, false otherwise
@@ -316,6 +518,49 @@ public:
         return true;
     }
 
+    /**
+     @brief controls if the timeseries lines are drawn from a GPU-resident vertex buffer instead of being rebuilt each frame.
+     In retained mode the raw samples live in a ring-buffered ofVbo, each update only uploads the samples written since the last draw,
+     and the ring offset and min/max scaling are applied in a vertex shader, so the per-frame CPU cost is independent of the timeseries length.
+     Retained mode requires the programmable renderer (GL 3.2+), if it is not available the plot falls back to immediate mode.
+     @param retainedRendering: if true, then the timeseries will be drawn using the retained vertex buffer
+     @return returns true if the parameter was update successfully, false otherwise
+    */
+    bool setRetainedRendering( const bool retainedRendering ){
+        std::unique_lock<std::mutex> lock( mtx );
+        this->retainedRendering = retainedRendering;
+        vboPendingSamples = timeseriesLength;
+        return true;
+    }
+
+    /**
+     @brief controls if long timeseries are drawn as a min/max envelope with one column per pixel, rather than one vertex per sample.
+     Each channel keeps cached min/max summaries over blocks of the ring that are updated as samples are pushed, so finding the envelope does not scan the buffer.
+     The envelope is only used when the timeseries has at least two samples per pixel, shorter timeseries are still drawn at full resolution.
+     @param decimation: if true, then the plot will be decimated to the pixel width of the plot
+     @return returns true if the parameter was update successfully, false otherwise
+    */
+    bool setDecimation( const bool decimation );
+
+    /**
+     @brief sets the type used to store the samples in the plot buffer, the samples already in the plot are converted to the new format.
+     The compact formats use 2x (int16, half) or 4x (uint8) less memory than float. Each channel stores (value - offset) / scale, if ranges are given then
+     the scale and offset of each channel are set so its range covers all the int16 or uint8 values, otherwise the scale is 1 and the offset is 0 so raw integer
+     streams (e.g. int16 ADC or IMU samples) are stored exactly. The ranges are not used by the half format, which keeps about 3 significant digits at any magnitude.
+     @param format: the storage format
+     @param ranges: the expected min/max value of each channel, this should be empty or contain one MinMax per channel
+     @return returns true if the format was set successfully, false otherwise
+    */
+    bool setSampleFormat( const ofxGrtSampleFormat format, const vector< GRT::MinMax > &ranges = vector< GRT::MinMax >() );
+
+    /**
+     @return returns the type used to store the samples in the plot buffer
+    */
+    ofxGrtSampleFormat getSampleFormat() const {
+        std::unique_lock<std::mutex> lock( mtx );
+        return dataBuffer.getFormat();
+    }
+
     /**
      @brief sets the background color of the plot
      @return returns true if the parameter was update successfully, false otherwise
@@ -323,6 +568,7 @@ public:
     bool setBackgroundColor( const ofColor &backgroundColor ){
         std::unique_lock<std::mutex> lock( mtx );
         this->backgroundColor = backgroundColor;
+        invalidateChrome();
         return true;
     }
   
@@ -373,7 +619,247 @@ public:
     void setAxisTitle(const std::string x, const std::string y);
     
 protected:
-    mutable std::mutex mtx;
+    /**
+     @brief converts a sample index (where 0 is the oldest sample and timeseriesLength-1 is the newest) into a ring index
+    */
+    inline unsigned int getRingIndex( const unsigned int i ) const {
+        const unsigned int index = bufferHead + i;
+        return index < timeseriesLength ? index : index - timeseriesLength;
+    }
+
+    /**
+     @brief returns a reader for the ring storage of the channel, the oldest sample is at getRingIndex(0)
+    */
+    inline ofxGrtSampleBuffer::Channel getChannelBuffer( const unsigned int channel ) const { return dataBuffer.getChannel( channel ); }
+
+    /**
+     @brief returns the most recent sample for the channel
+    */
+    inline float getLatestValue( const unsigned int channel ) const {
+        return dataBuffer.get( channel, bufferHead == 0 ? timeseriesLength-1 : bufferHead-1 );
+    }
+
+    /**
+     @brief writes one sample per channel into the ring, the caller must hold the mutex and the data must contain numChannels values
+    */
+    void pushSample( const float *data, const bool highlight, const std::string &label, const uint64_t timestamp );
+
+    /**
+     @brief returns the ID for the label, adding it to the label table if needed, the caller must hold the mutex
+    */
+    unsigned short internLabel( const std::string &label );
+
+    /**
+     @brief clears all the labels in the ring and resets the label table so it only contains the empty label, the caller must hold the mutex
+    */
+    void clearLabelTable();
+
+    /**
+     @brief returns the key used for the highlight spans for the ring slot, this is 0 if the slot is not highlighted or the label ID + 1 if it is
+    */
+    inline int getHighlightKey( const unsigned int index ) const {
+        return highlightBuffer[ index ] ? labelBuffer[ index ] + 1 : 0;
+    }
+
+    /**
+     @brief rebuilds the highlight spans from the ring, the caller must hold the mutex
+    */
+    void rebuildHighlightSpans();
+
+    /**
+     @brief rebuilds the class spans from the channel in the ring, the caller must hold the mutex
+    */
+    void rebuildClassSpans( const unsigned int channel );
+
+    /**
+     @brief moves all the samples waiting in the ingest queue into the ring, the caller must hold the mutex
+    */
+    void drainIngestQueue();
+
+    /**
+     @brief fills the ring with the latest data published by the lock-free setData path (if any), the caller must hold the mutex
+    */
+    void applySnapshot();
+
+    /**
+     @brief fills the single channel ring with the data and updates the ranges, the caller must hold the mutex
+     @return returns true if the data matches the plot size, false otherwise
+    */
+    template< class T > bool applyData( const T *data, const unsigned int size );
+
+    /**
+     @brief copies the data into the snapshot buffer and publishes it, this is only called by the producer while it is inside the snapshotGate
+     @return returns true if the data matches the snapshot size, false otherwise
+    */
+    template< class T > bool publishSnapshot( const T *data, const unsigned int size );
+
+    /**
+     @brief writes numFrames samples for one channel into the ring (starting at the current head) and updates that channels ranges,
+     the caller must hold the mutex and advance the head once all channels have been written
+     @param source: the first sample for the channel
+     @param stride: the distance between consecutive samples in the source
+    */
+    void writeChannelFrames( const unsigned int channel, const float *source, const size_t stride, const size_t numFrames );
+
+    /**
+     @brief sets the highlight, label and timestamp for the last numFrames slots written by writeChannelFrames and advances the head past them, the caller must hold the mutex
+    */
+    void finishFrames( const size_t numFrames, const bool highlight, const std::string &label, const uint64_t timestamp );
+
+    /**
+     @brief writes the timestamp for the ring slot, which must be the slot after the newest sample. The timestamp is clamped so the ring never decreases from the oldest to the newest slot
+    */
+    inline void setTimestamp( const unsigned int index, const uint64_t timestamp ){
+        const uint64_t newest = timestampBuffer[ index == 0 ? timeseriesLength-1 : index-1 ];
+        timestampBuffer[ index ] = timestamp > newest ? timestamp : newest;
+        if( numTimestamps < timeseriesLength ) numTimestamps++;
+    }
+
+    /**
+     @brief returns the oldest sample (as an offset from getRingIndex(0)) drawn in the time window, and sets windowStart to the time at the left edge of the plot.
+     If the time window is not set this returns 0, the caller must hold the mutex
+    */
+    unsigned int getFirstVisibleSample( uint64_t &windowStart ) const;
+
+    /**
+     @brief returns the x position of the sample (as an offset from getRingIndex(0)) relative to the start of the plot area, offsets past the newest sample map to the right edge
+    */
+    inline float getSampleX( const unsigned int i, const float plotWidth, const uint64_t windowStart ) const {
+        if( timeWindow == 0 ) return i * plotWidth / (float)timeseriesLength;
+        if( i >= timeseriesLength ) return plotWidth;
+        const uint64_t timestamp = timestampBuffer[ getRingIndex( i ) ];
+        return timestamp > windowStart ? (timestamp - windowStart) * plotWidth / (float)timeWindow : 0.0f;
+    }
+
+    /**
+     @brief returns the value the sample (as an offset from getRingIndex(0)) is drawn with. The sample kept from before the time window is drawn at the left
+     edge by getSampleX, so its value is interpolated to windowStart between it and the next sample, which keeps the first segment on the original line
+    */
+    inline float getSampleValue( const ofxGrtSampleBuffer::Channel &channelData, const unsigned int i, const uint64_t windowStart ) const {
+        const float value = channelData[ getRingIndex( i ) ];
+        if( timeWindow == 0 || i+1 >= timeseriesLength ) return value;
+        const uint64_t timestamp = timestampBuffer[ getRingIndex( i ) ];
+        const uint64_t nextTimestamp = timestampBuffer[ getRingIndex( i+1 ) ];
+        if( timestamp >= windowStart || nextTimestamp <= windowStart ) return value;
+        const float nextValue = channelData[ getRingIndex( i+1 ) ];
+        return value + (nextValue - value) * (float)( (double)(windowStart - timestamp) / (double)(nextTimestamp - timestamp) );
+    }
+
+    /**
+     @brief rebuilds the sliding min/max and envelope summaries for each channel from the contents of the ring, and flags the vbo for a full upload.
+     This should be called after the ring is overwritten (e.g. by setData)
+    */
+    void rebuildChannelSummaries();
+
+    /**
+     @brief sets the channel and global ranges from the sliding min/max of each channel, this is O(numChannels)
+    */
+    void updateDynamicRanges();
+
+    /**
+     @brief sets the channel and global ranges from the lower/upper quantile of each channel, this is O(numChannels)
+    */
+    void updateRobustRanges();
+
+    /**
+     @brief rebuilds the running statistics of the channel from the ring, the caller must hold the mutex
+    */
+    void rebuildChannelStatistics( const unsigned int channel );
+
+    /**
+     @brief writes a value into the ring slot, updating the running statistics with the value it replaces, the caller must hold the mutex
+    */
+    inline void setRingValue( const unsigned int channel, const unsigned int index, const float value ){
+        if( !statisticsEnabled ){
+            dataBuffer.set( channel, index, value );
+            return;
+        }
+        //The statistics use the stored value, so a compact sample format evicts exactly what it added
+        const float evicted = dataBuffer.get( channel, index );
+        dataBuffer.set( channel, index, value );
+        channelStatistics[ channel ].push( dataBuffer.get( channel, index ), evicted );
+    }
+
+    /**
+     @brief draws the mean and standard deviation band of each visible channel, the caller must hold the mutex
+    */
+    void drawStatisticsOverlay( const float plotWidth, const float plotHeight );
+
+    /**
+     @brief uploads the samples written since the last draw into the vbo, the vbo is only reallocated if the plot size has changed. The caller must hold the mutex
+    */
+    void uploadPendingSamples();
+
+    /**
+     @brief draws the timeseries lines from the vbo using the retained shader, the caller must hold the mutex
+    */
+    bool drawRetainedTimeseries( const float plotWidth, const float plotHeight );
+
+    /**
+     @brief draws the background, grid, axes, axis labels and ticks for draw, this is cached in the chromeLayer
+    */
+    void drawChrome( const float w, const float h );
+
+    /**
+     @brief draws the background, grid, axes, axis labels and ticks for drawLabeledGraph, this is cached in the labeledChromeLayer
+    */
+    void drawLabeledChrome( const float w, const float h );
+
+    /**
+     @brief returns the distance the chrome can extend outside of the plot area
+    */
+    float getChromePadding() const;
+
+    /**
+     @brief flags the cached chrome to be redrawn, this should be called when any setting the chrome depends on changes
+    */
+    void invalidateChrome(){
+        chromeLayer.invalidate();
+        labeledChromeLayer.invalidate();
+    }
+
+    /**
+     @brief draws the recorded frames selected by scrubRecording, the caller must hold the mutex
+     @return returns true if the frames were drawn, false if the plot is not scrubbing a recording
+    */
+    bool drawRecordedTimeseries( const float plotWidth, const float plotHeight );
+
+    /**
+     @brief draws the history view window for each channel as a min/max envelope, the caller must hold the mutex
+     @return returns true if the window was drawn, false if the history is disabled or the live view is selected
+    */
+    bool drawHistoryTimeseries( const float plotWidth, const float plotHeight );
+
+    /**
+     @brief draws each channel as a min/max envelope with one column per pixel, this is only used if decimation is enabled and there are at least two samples per pixel
+     @return returns true if the timeseries was drawn, false if the plot should be drawn at full resolution instead
+    */
+    bool drawDecimatedTimeseries( const float plotWidth, const float plotHeight );
+
+    /**
+     @brief draws the samples in the time window at their timestamps, the caller must hold the mutex
+     @return returns true if the timeseries was drawn, false if the time window is not set
+    */
+    bool drawTimedTimeseries( const float plotWidth, const float plotHeight );
+
+    /**
+     @brief draws the latest value and range of each visible channel starting at [textX,textY], the text is rebuilt if the refresh interval has elapsed, the caller must hold the mutex
+    */
+    void drawPlotValueText( const int textX, int textY );
+
+    /**
+     @brief draws the plot, the caller must hold the mutex. If lineMesh is not NULL then the live timeseries lines are appended to it
+     (in the caller's coordinates) rather than drawn, so a group of plots can draw all their lines in one call
+    */
+    bool drawPlot( int x, int y, int w, int h, ofMesh *lineMesh );
+
+    /**
+     @brief appends the live timeseries of each visible channel to the mesh as line segments, offset by [x,y], the caller must hold the mutex
+    */
+    void appendLiveLines( ofMesh &lineMesh, const float x, const float y, const float plotWidth, const float plotHeight ) const;
+
+    mutable std::mutex mtx; ///< Guards the plot, an ofxGrtPlotGroup also locks it while it updates or draws the plot
+    ofxGrtPlotGroup *group; ///< The group the plot has been added to (or NULL), so the plot can leave the group when it is destroyed
     unsigned int numChannels;
     unsigned int timeseriesLength;
     float globalMin;
@@ -382,10 +868,58 @@ protected:
     vector< std::string > channelNames;
     std::vector< bool > channelVisible;
     vector< std::pair<float,float> > channelRanges;
-    CircularBuffer< vector<float> > dataBuffer;
-    CircularBuffer< int > highlightBuffer;
-    CircularBuffer< std::string > labelBuffer;
+    ofxGrtSampleBuffer dataBuffer; ///< Channel-major ring storage, channel n occupies [n*timeseriesLength, (n+1)*timeseriesLength)
+    vector< unsigned char > highlightBuffer; ///< One flag per ring slot, shares bufferHead with the dataBuffer
+    vector< unsigned short > labelBuffer; ///< One interned label ID per ring slot (ID 0 is the empty label), shares bufferHead with the dataBuffer
+    vector< uint64_t > timestampBuffer; ///< One timestamp per ring slot, shares bufferHead with the dataBuffer and never decreases from the oldest slot to the newest
+    unsigned int numTimestamps; ///< The number of slots (ending at the newest) that hold a timestamped sample
+    uint64_t timeWindow; ///< The length of the time window drawn by the live view, 0 if the samples are spaced evenly
+    vector< std::string > labelTable; ///< The interned labels, indexed by label ID
+    std::unordered_map< std::string, unsigned short > labelTableIndex; ///< Maps each interned label to its ID
+    unsigned short lastLabelId; ///< The ID of the last label interned, consecutive samples usually share a label so this is checked first
+    ofxGrtSpanList highlightSpans; ///< Run-length spans of the highlight key (0 if not highlighted, otherwise label ID + 1) of each sample in the ring
+    ofxGrtSpanList classSpans; ///< Run-length spans of the class labels drawn by drawLabeledGraph, built from classSpanChannel
+    int classSpanChannel; ///< The channel the classSpans are built from, -1 if the spans need to be rebuilt on the next drawLabeledGraph
+    vector< std::string > classLabelText; ///< Cached text for each class label drawn by drawLabeledGraph
+    unsigned int bufferHead; ///< Ring index of the oldest sample, this is also the slot that will be written by the next update
+    vector< ofxGrtSlidingExtrema > channelExtrema; ///< Min/max of the samples currently in each channel ring, used when dynamicScale is true
+    bool decimation; ///< If true, then timeseries with more samples than pixels will be drawn as a min/max envelope
+    vector< ofxGrtRingEnvelope > channelEnvelopes; ///< Block min/max summaries of each channel ring, only maintained when decimation is true
+    bool statisticsEnabled; ///< If true, then the running statistics of each channel are updated as samples are added
+    vector< ofxGrtStreamingStats > channelStatistics; ///< Running statistics of each channel ring, only maintained when statisticsEnabled is true
+    float statisticsLowerQuantile;
+    float statisticsUpperQuantile;
+    bool drawStatistics; ///< If true, then the mean and standard deviation band of each channel is drawn over the plot
+    bool robustScale; ///< If true, then the plot ranges are set from the lower/upper quantiles of each channel rather than the min/max
+
+    bool retainedRendering; ///< If true, then the timeseries will be drawn from the vbo rather than in immediate mode
+    ofVbo vbo; ///< Mirrors the dataBuffer with each channel stored twice ([ring][ring]) so any window of timeseriesLength samples is contiguous
+    unsigned int vboLength; ///< The timeseries length the vbo was allocated for
+    unsigned int vboChannels; ///< The number of channels the vbo was allocated for
+    unsigned int vboPendingSamples; ///< The number of samples written to the ring since the last upload, timeseriesLength refreshes the whole vbo
+    vector< float > vboScratch; ///< Holds the mirror when the vbo is allocated and the decoded samples for uploads when the ring uses a compact sample format
+
+    bool historyEnabled; ///< If true, then every sample is also written to the history pyramid
+    ofxGrtHistoryPyramid history;
+    unsigned long long historyViewLength; ///< The number of samples in the history view window, 0 if the live view is drawn
+    unsigned long long historyViewOffset; ///< The number of samples between the newest sample and the end of the history view window
+    vector< ofxGrtHistoryPyramid::Bucket > historyBuckets; ///< Reused by drawHistoryTimeseries so drawing does not allocate
+
+    ofxGrtRecorder recorder; ///< Records every sample added to the plot if a recording is open
+    bool scrubbing; ///< If true, then the plot draws the recorded frames starting at scrubFrame rather than the live data
+    unsigned long long scrubFrame;
+
+    ofxGrtProducerGate ingestGate; ///< Open while update(data,...) pushes into the ingestQueue rather than taking the mutex, closed before the queue is reallocated
+    ofxGrtIngestQueue ingestQueue;
+    ofxGrtIngestQueue::Frame ingestFrame; ///< Reused by drainIngestQueue so draining does not allocate
+    std::string ingestLabel; ///< Reused by drainIngestQueue to pass each frame label to pushSample
+    ofxGrtProducerGate snapshotGate; ///< Open while setData publishes into the snapshot rather than taking the mutex, closed before the snapshot is reallocated
+    ofxGrtSnapshotBuffer snapshot; ///< Passes the data from the lock-free setData path to draw
+    vector< float > ingestScratch; ///< Used by the producer to convert or interleave a block before it is queued (or pushed under the lock when the queue is disabled)
     
+    ofxGrtCachedLayer chromeLayer; ///< The cached background, grid, axes and ticks drawn by draw
+    ofxGrtCachedLayer labeledChromeLayer; ///< The cached background, grid, axes and ticks drawn by drawLabeledGraph
+
     std::string xAxisInfo, yAxisInfo;
     bool insetPlotByInfoMarginX, insetPlotByInfoMarginY;
     
@@ -409,6 +943,10 @@ protected:
     vector< labelPlotColor > labelPlotColors;
     ErrorLog errorLog;
     const ofTrueTypeFont *font;
+    ofxGrtTextCache textCache; ///< Glyph meshes for the title, axis and value text
+    vector< std::string > valueText; ///< The plot values text for each channel, rebuilt at most valueTextRefreshRate times per second
+    float valueTextRefreshRate;
+    uint64_t valueTextUpdateTime; ///< The time (in ms) the valueText was last rebuilt
     std::shared_ptr<ofxGrtSettings::variables> config;
 };
 
@@ -0,0 +1,80 @@
+/**
+ Headless check of the ofxGrtBarPlot instanced bar shader. The shader and the unit quad (barQuad) are read from the addon source and the bars are
+ drawn with them, the height and position of every rendered bar are compared against the rectangles of the fallback path.
+ This only checks the shader and the quad. The vertex, attribute and divisor setup below is written by hand to match drawInstancedBars(),
+ the ofVbo calls the plot itself makes need openFrameworks and are not covered.
+ */
+
+#include "ofxGrtTestGL.h"
+#include <cmath>
+
+static const int PLOT_WIDTH = 200;
+static const int PLOT_HEIGHT = 100;
+static const unsigned int NUM_BARS = 4;
+static const int BAR_ATTRIBUTE = 4;
+
+int main(){
+    ofxGrtTestGL gl( PLOT_WIDTH, PLOT_HEIGHT );
+    const GLuint program = ofxGrtTestGL::createProgram(
+        ofxGrtTestGL::loadShaderSource( "../src/ofxGrtBarPlot.cpp", "barVertexShader" ),
+        ofxGrtTestGL::loadShaderSource( "../src/ofxGrtBarPlot.cpp", "barFragmentShader" ) );
+    glBindAttribLocation( program, BAR_ATTRIBUTE, "bar" );
+    glLinkProgram( program );
+    const std::vector< float > barQuad = ofxGrtTestGL::loadFloatArray( "../src/ofxGrtBarPlot.cpp", "barQuad" );
+    TEST_CHECK( barQuad.size() == 8 );
+
+    //[value min max] per bar, the last bar has an empty range and must not be drawn
+    const float barData[NUM_BARS*3] = { 0,0,10, 2.5f,0,10, 10,0,10, 5,5,5 };
+
+    GLuint vao = 0, buffers[2];
+    glGenVertexArrays( 1, &vao );
+    glGenBuffers( 2, buffers );
+    glBindVertexArray( vao );
+    glBindBuffer( GL_ARRAY_BUFFER, buffers[0] );
+    glBufferData( GL_ARRAY_BUFFER, barQuad.size()*sizeof(float), &barQuad[0], GL_STATIC_DRAW );
+    glEnableVertexAttribArray( 0 );
+    glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, 2*sizeof(float), 0 );
+    glBindBuffer( GL_ARRAY_BUFFER, buffers[1] );
+    glBufferData( GL_ARRAY_BUFFER, sizeof(barData), barData, GL_DYNAMIC_DRAW );
+    glEnableVertexAttribArray( BAR_ATTRIBUTE );
+    glVertexAttribPointer( BAR_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), 0 );
+    glVertexAttribDivisor( BAR_ATTRIBUTE, 1 );
+    glBindVertexArray( 0 );
+
+    const float barWidth = floor( PLOT_WIDTH/(NUM_BARS+1.0) );
+    const float barSpacer = (PLOT_WIDTH-(barWidth*NUM_BARS))/NUM_BARS;
+
+    gl.clear();
+    glUseProgram( program );
+    gl.setScreenProjection( program );
+    glUniform1f( glGetUniformLocation( program, "xStart" ), barSpacer/2.0 );
+    glUniform1f( glGetUniformLocation( program, "barStep" ), barWidth + barSpacer );
+    glUniform1f( glGetUniformLocation( program, "barWidth" ), barWidth );
+    glUniform1f( glGetUniformLocation( program, "plotHeight" ), PLOT_HEIGHT );
+    glUniform1i( glGetUniformLocation( program, "constrainValues" ), 1 );
+    glUniform4f( glGetUniformLocation( program, "barColor" ), 1, 0, 0, 1 );
+    glBindVertexArray( vao );
+    glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4, NUM_BARS );
+    glBindVertexArray( 0 );
+    TEST_CHECK( glGetError() == GL_NO_ERROR );
+    gl.readPixels();
+
+    //Each bar must cover the rows the fallback would draw with ofDrawRectangle, ending one pixel above the bottom of the plot
+    for(unsigned int n=0; n<NUM_BARS; n++){
+        const int centre = (int)( barSpacer/2.0 + n*(barWidth+barSpacer) + barWidth/2.0 );
+        const int gap = (int)( barSpacer/2.0 + n*(barWidth+barSpacer) + barWidth + barSpacer/2.0 );
+        float meanY = 0;
+        const int coverage = gl.getColumnCoverage( centre, meanY );
+        if( barData[n*3+1] == barData[n*3+2] ){
+            TEST_CHECK( coverage == 0 );
+        }else{
+            const float barHeight = 1.0f + (barData[n*3] - barData[n*3+1]) / (barData[n*3+2] - barData[n*3+1]) * (PLOT_HEIGHT - 2.0f);
+            TEST_CHECK( fabs( coverage - barHeight ) <= 1.0f );
+            TEST_CHECK( fabs( meanY - (PLOT_HEIGHT - 1.0f - barHeight/2.0f) ) <= 1.0f );
+        }
+        if( gap < PLOT_WIDTH ) TEST_CHECK( gl.getColumnCoverage( gap, meanY ) == 0 );
+    }
+
+    printf( "barInstancedTest passed\n" );
+    return EXIT_SUCCESS;
+}
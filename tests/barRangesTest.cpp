@@ -0,0 +1,176 @@
+/**
+ Check of ofxGrtBarRanges, the range, peak and dynamic scaling logic of ofxGrtBarPlot. A steady signal must not fill the plot once the peaks have
+ decayed onto it, linked ranges must be shared by every bar, and the peaks (and on the lock-free path the producer's extremes) must restart after
+ the ranges are reset or set. The lock-free path, where the consumer only merges some of the frames the producer tracks, must end up with the same
+ ranges and peaks as the locked path that applies every frame.
+ */
+
+#include "../src/ofxGrtBarRanges.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#define TEST_CHECK( cond ) do{ if( !(cond) ){ fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond ); exit( EXIT_FAILURE ); } }while(0)
+
+static const float PEAK_DECAY = 1.0f - std::pow( 0.5f, 1.0f / 10.0f );
+static const float MIN_DYNAMIC_RANGE = 0.05f;
+
+//Feeds the same frames to the locked path and to the lock-free path, the consumer only merges every mergeInterval frames
+struct BothPaths{
+    BothPaths( const unsigned int numBars, const unsigned int mergeInterval ) : mergeInterval( mergeInterval ), numFrames( 0 ) {
+        locked.setup( numBars );
+        lockFree.setup( numBars );
+        lockFree.setupProducer();
+        frame.resize( lockFree.getFrameSize() );
+    }
+    void update( const std::vector< float > &values ){
+        locked.update( &values[0], true, PEAK_DECAY );
+        lockFree.track( &values[0], &frame[0], PEAK_DECAY );
+        if( ++numFrames % mergeInterval == 0 ) lockFree.merge( &frame[0], true );
+    }
+    void flush(){ lockFree.merge( &frame[0], true ); }
+    void restart(){ locked.restart(); lockFree.restart(); }
+    void setRange( const unsigned int bar, const float minValue, const float maxValue ){
+        locked.setRange( bar, minValue, maxValue );
+        lockFree.setRange( bar, minValue, maxValue );
+    }
+    void checkSame() const {
+        for(unsigned int n=0; n<locked.getNumBars(); n++){
+            TEST_CHECK( locked.getMinRange(n) == lockFree.getMinRange(n) );
+            TEST_CHECK( locked.getMaxRange(n) == lockFree.getMaxRange(n) );
+            TEST_CHECK( locked.getMinPeak(n) == lockFree.getMinPeak(n) );
+            TEST_CHECK( locked.getMaxPeak(n) == lockFree.getMaxPeak(n) );
+        }
+    }
+    ofxGrtBarRanges locked;
+    ofxGrtBarRanges lockFree;
+    std::vector< float > frame;
+    const unsigned int mergeInterval;
+    unsigned int numFrames;
+};
+
+//Returns where the value sits in the draw range of the bar, 1 fills the plot
+static float getBarFraction( const ofxGrtBarRanges &ranges, const unsigned int bar, const float value ){
+    return (value - ranges.getDrawMinRange(bar)) / (ranges.getDrawMaxRange(bar) - ranges.getDrawMinRange(bar));
+}
+
+static void testSteadySignal(){
+    BothPaths paths( 1, 7 );
+    std::vector< float > values( 1, 0 );
+    paths.update( values );
+    values[0] = 10;
+    paths.update( values );
+    values[0] = 1;
+    for(int i=0; i<1000; i++) paths.update( values );
+    paths.flush();
+    paths.checkSame();
+
+    //The spike was only seen by frames the consumer skipped, it must still be in the grown range
+    TEST_CHECK( paths.lockFree.getMaxRange(0) == 10 );
+
+    ofxGrtBarRanges *ranges[2] = { &paths.locked, &paths.lockFree };
+    for(int i=0; i<2; i++){
+        ofxGrtBarRanges &path = *ranges[i];
+        //The peaks have decayed onto the signal, the floor keeps the dynamic range at 5% of the grown range with the signal in the middle
+        TEST_CHECK( std::fabs( path.getMaxPeak(0) - 1 ) < 1.0e-4f );
+        path.computeDrawRanges( false, false, true, MIN_DYNAMIC_RANGE );
+        TEST_CHECK( std::fabs( (path.getDrawMaxRange(0) - path.getDrawMinRange(0)) - 0.5f ) < 1.0e-4f );
+        TEST_CHECK( std::fabs( getBarFraction( path, 0, 1 ) - 0.5f ) < 1.0e-3f );
+        TEST_CHECK( std::fabs( getBarFraction( path, 0, 1.2f ) - 0.9f ) < 1.0e-3f );
+
+        //Locked ranges are used as they are even with dynamic scaling
+        path.computeDrawRanges( true, false, true, MIN_DYNAMIC_RANGE );
+        TEST_CHECK( path.getDrawMinRange(0) == 0 && path.getDrawMaxRange(0) == 10 );
+    }
+
+    //An empty grown range gives an empty draw range, so the bar is not drawn, as it is without dynamic scaling
+    ofxGrtBarRanges empty;
+    empty.setup( 1 );
+    values[0] = 0;
+    for(int i=0; i<10; i++) empty.update( &values[0], true, PEAK_DECAY );
+    empty.computeDrawRanges( false, false, true, MIN_DYNAMIC_RANGE );
+    TEST_CHECK( empty.getDrawMinRange(0) == empty.getDrawMaxRange(0) );
+}
+
+static void testLinkedRanges(){
+    ofxGrtBarRanges ranges;
+    ranges.setup( 3 );
+    ranges.setRange( 0, 0, 1 );
+    ranges.setRange( 1, -5, 2 );
+    ranges.setRange( 2, 1, 3 );
+
+    ranges.computeDrawRanges( true, true, false, MIN_DYNAMIC_RANGE );
+    for(unsigned int n=0; n<3; n++){
+        TEST_CHECK( ranges.getDrawMinRange(n) == -5 && ranges.getDrawMaxRange(n) == 3 );
+    }
+    ranges.computeDrawRanges( true, false, false, MIN_DYNAMIC_RANGE );
+    TEST_CHECK( ranges.getDrawMinRange(1) == -5 && ranges.getDrawMaxRange(1) == 2 );
+    TEST_CHECK( ranges.getDrawMinRange(2) == 1 && ranges.getDrawMaxRange(2) == 3 );
+
+    //With dynamic scaling the linked peaks are shared, and the floor is a fraction of the linked range (8) rather than of each bar
+    std::vector< float > values( 3, 0.5f );
+    values[1] = 0.5f;
+    values[2] = 1.5f;
+    for(int i=0; i<1000; i++) ranges.update( &values[0], true, PEAK_DECAY );
+    ranges.computeDrawRanges( false, true, true, MIN_DYNAMIC_RANGE );
+    for(unsigned int n=0; n<3; n++){
+        TEST_CHECK( ranges.getDrawMinRange(n) == ranges.getDrawMinRange(0) && ranges.getDrawMaxRange(n) == ranges.getDrawMaxRange(0) );
+    }
+    TEST_CHECK( std::fabs( ranges.getDrawMinRange(0) - 0.5f ) < 1.0e-4f );
+    TEST_CHECK( std::fabs( ranges.getDrawMaxRange(0) - 1.5f ) < 1.0e-4f );
+    values[2] = 0.5f;
+    for(int i=0; i<1000; i++) ranges.update( &values[0], true, PEAK_DECAY );
+    ranges.computeDrawRanges( false, true, true, MIN_DYNAMIC_RANGE );
+    TEST_CHECK( std::fabs( (ranges.getDrawMaxRange(0) - ranges.getDrawMinRange(0)) - 8 * MIN_DYNAMIC_RANGE ) < 1.0e-4f );
+}
+
+static void testRestart(){
+    BothPaths paths( 2, 5 );
+    std::vector< float > values( 2, 0 );
+    for(int i=0; i<20; i++){
+        values[0] = (float)(i % 4);
+        values[1] = -(float)(i % 3);
+        paths.update( values );
+    }
+    values[0] = 10;
+    values[1] = -10;
+    paths.update( values );
+    paths.flush();
+    paths.checkSame();
+    TEST_CHECK( paths.locked.getMaxPeak(0) == 10 && paths.locked.getMinPeak(1) == -10 );
+
+    //resetAxisRanges: the peaks restart from the next frame on both paths
+    paths.restart();
+    values[0] = 3;
+    values[1] = -2;
+    paths.update( values );
+    paths.flush();
+    paths.checkSame();
+    TEST_CHECK( paths.locked.getMinPeak(0) == 3 && paths.locked.getMaxPeak(0) == 3 );
+    TEST_CHECK( paths.locked.getMinPeak(1) == -2 && paths.locked.getMaxPeak(1) == -2 );
+
+    //setRanges: the new ranges are kept, the extremes the producer saw before the restart must not grow them again
+    paths.setRange( 0, 2, 4 );
+    paths.setRange( 1, -3, -1 );
+    paths.restart();
+    paths.update( values );
+    paths.flush();
+    paths.checkSame();
+    TEST_CHECK( paths.lockFree.getMinRange(0) == 2 && paths.lockFree.getMaxRange(0) == 4 );
+    TEST_CHECK( paths.lockFree.getMinRange(1) == -3 && paths.lockFree.getMaxRange(1) == -1 );
+
+    //setupProducer (as setup and setLockFreeUpdates do) also restarts the producer
+    paths.lockFree.setupProducer();
+    values[0] = 3.5f;
+    paths.lockFree.track( &values[0], &paths.frame[0], PEAK_DECAY );
+    paths.lockFree.merge( &paths.frame[0], true );
+    TEST_CHECK( paths.lockFree.getMinPeak(0) == 3.5f && paths.lockFree.getMaxPeak(0) == 3.5f );
+}
+
+int main(){
+    testSteadySignal();
+    testLinkedRanges();
+    testRestart();
+    printf( "barRangesTest passed\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+/**
+ Stress test for ofxGrtIngestQueue and ofxGrtProducerGate, build it with -fsanitize=thread to check for data races.
+ A producer thread pushes numbered frames while the consumer drains them. Every frame must be read whole and in order,
+ with the coalesce policy the last frame must arrive even though the producer stops pushing once it is queued.
+ A second run reallocates the queue behind the gate while the producer is still pushing.
+ */
+
+#include "../src/ofxGrtIngestQueue.h"
+#include "../src/ofxGrtProducerGate.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#define TEST_CHECK( cond ) do{ if( !(cond) ){ fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond ); exit( EXIT_FAILURE ); } }while(0)
+
+static const unsigned int FRAME_SIZE = 4;
+static const int NUM_FRAMES = 500000;
+
+//Checks the frame is whole (every value, the label and the timestamp come from the same push) and newer than the last frame
+static void checkFrame( const ofxGrtIngestQueue::Frame &frame, float &lastValue ){
+    for(unsigned int k=0; k<FRAME_SIZE; k++) TEST_CHECK( frame.data[k] == frame.data[0] );
+    TEST_CHECK( frame.timestamp == (uint64_t)frame.data[0] );
+    char label[32];
+    snprintf( label, sizeof(label), "frame%d", (int)frame.data[0] % 8 );
+    TEST_CHECK( strcmp( frame.label, label ) == 0 );
+    TEST_CHECK( frame.data[0] > lastValue );
+    lastValue = frame.data[0];
+}
+
+static void testPolicy( const ofxGrtIngestQueue::OverflowPolicy policy ){
+    ofxGrtIngestQueue queue;
+    TEST_CHECK( queue.setup( 64, FRAME_SIZE, policy ) );
+
+    std::string labels[8];
+    for(int i=0; i<8; i++) labels[i] = "frame" + std::to_string( i );
+
+    std::atomic< bool > done( false );
+    std::thread producer( [&](){
+        float data[ FRAME_SIZE ];
+        for(int i=1; i<=NUM_FRAMES; i++){
+            for(unsigned int k=0; k<FRAME_SIZE; k++) data[k] = (float)i;
+            queue.push( data, false, labels[ i % 8 ], i );
+        }
+        done = true;
+    } );
+
+    ofxGrtIngestQueue::Frame frame;
+    float lastValue = 0;
+    unsigned long long numRead = 0;
+    while( !done ){
+        while( queue.pop( frame ) ){ checkFrame( frame, lastValue ); numRead++; }
+    }
+    producer.join();
+    while( queue.pop( frame ) ){ checkFrame( frame, lastValue ); numRead++; }
+
+    printf( "policy %d: read %llu dropped %llu last %d\n", (int)policy, numRead, queue.getNumDroppedFrames(), (int)lastValue );
+    if( policy == ofxGrtIngestQueue::COALESCE ) TEST_CHECK( lastValue == NUM_FRAMES );
+}
+
+static void testReallocation(){
+    ofxGrtIngestQueue queue;
+    ofxGrtProducerGate gate;
+    TEST_CHECK( queue.setup( 16, FRAME_SIZE, ofxGrtIngestQueue::COALESCE ) );
+    gate.open();
+
+    std::atomic< bool > done( false );
+    std::thread producer( [&](){
+        float data[ FRAME_SIZE ] = { 1, 1, 1, 1 };
+        for(int i=0; i<NUM_FRAMES; i++){
+            if( gate.enter() ){
+                queue.push( data, false, "frame1", 1 );
+                gate.leave();
+            }
+        }
+        done = true;
+    } );
+
+    ofxGrtIngestQueue::Frame frame;
+    unsigned int numReallocations = 0;
+    while( !done ){
+        while( queue.pop( frame ) ){}
+        gate.close();
+        TEST_CHECK( queue.setup( 16 + numReallocations % 16, FRAME_SIZE, ofxGrtIngestQueue::COALESCE ) );
+        gate.open();
+        numReallocations++;
+    }
+    producer.join();
+    printf( "reallocated the queue %u times while the producer was running\n", numReallocations );
+}
+
+int main(){
+    testPolicy( ofxGrtIngestQueue::DROP_OLDEST );
+    testPolicy( ofxGrtIngestQueue::DROP_NEWEST );
+    testPolicy( ofxGrtIngestQueue::COALESCE );
+    testReallocation();
+    printf( "ingestQueueStressTest passed\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/*
+ GRT MIT License
+ Copyright (c) <2012> <Nicholas Gillian, Media Lab, MIT>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial
+ portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+ LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ @file ofxGrtTestGL.h
+ @brief Minimal headless GL harness for the shader tests. It creates a core 3.2 context on EGL's surfaceless platform (Mesa's llvmpipe works),
+ renders into an offscreen framebuffer and compiles the shaders straight from the addon sources so the tests can't drift from them.
+ The GL calls mirror what ofVbo and ofShader issue under the programmable renderer.
+ */
+
+#ifndef OFX_GRT_TEST_GL_HEADER
+#define OFX_GRT_TEST_GL_HEADER
+
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define TEST_CHECK( cond ) do{ if( !(cond) ){ fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond ); exit( EXIT_FAILURE ); } }while(0)
+
+class ofxGrtTestGL{
+public:
+    ofxGrtTestGL( const int width, const int height ) : width(width), height(height) {
+        //The surfaceless platform needs no window system, everything is drawn into the framebuffer object below
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+        TEST_CHECK( getPlatformDisplay != NULL );
+        display = getPlatformDisplay( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL );
+        TEST_CHECK( display != EGL_NO_DISPLAY );
+        TEST_CHECK( eglInitialize( display, NULL, NULL ) );
+
+
+        TEST_CHECK( eglBindAPI( EGL_OPENGL_API ) );
+        const EGLint contextAttributes[] = { EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 2,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+        context = eglCreateContext( display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes );
+        TEST_CHECK( context != EGL_NO_CONTEXT );
+        TEST_CHECK( eglMakeCurrent( display, EGL_NO_SURFACE, EGL_NO_SURFACE, context ) );
+        printf( "GL_RENDERER: %s\n", glGetString( GL_RENDERER ) );
+
+        glGenRenderbuffers( 1, &colorBuffer );
+        glBindRenderbuffer( GL_RENDERBUFFER, colorBuffer );
+        glRenderbufferStorage( GL_RENDERBUFFER, GL_RGBA8, width, height );
+        glGenFramebuffers( 1, &framebuffer );
+        glBindFramebuffer( GL_FRAMEBUFFER, framebuffer );
+        glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer );
+        TEST_CHECK( glCheckFramebufferStatus( GL_FRAMEBUFFER ) == GL_FRAMEBUFFER_COMPLETE );
+        glViewport( 0, 0, width, height );
+        pixels.resize( width*height*4 );
+    }
+
+    ~ofxGrtTestGL(){
+        glDeleteFramebuffers( 1, &framebuffer );
+        glDeleteRenderbuffers( 1, &colorBuffer );
+        eglMakeCurrent( display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+        eglDestroyContext( display, context );
+        eglTerminate( display );
+    }
+
+    //Returns the contents of the raw string literal assigned to name in the source file
+    static std::string loadShaderSource( const std::string &filename, const std::string &name ){
+        std::ifstream file( filename.c_str() );
+        TEST_CHECK( file.is_open() );
+        std::stringstream stream;
+        stream << file.rdbuf();
+        const std::string source = stream.str();
+        const std::string open = name + " = R\"(";
+        const size_t start = source.find( open );
+        TEST_CHECK( start != std::string::npos );
+        const size_t end = source.find( ")\";", start );
+        TEST_CHECK( end != std::string::npos );
+        return source.substr( start + open.size(), end - start - open.size() );
+    }
+
+    //Returns the values of the float array initialised as name[N] = { ... } in the source file
+    static std::vector< float > loadFloatArray( const std::string &filename, const std::string &name ){
+        std::ifstream file( filename.c_str() );
+        TEST_CHECK( file.is_open() );
+        std::stringstream stream;
+        stream << file.rdbuf();
+        const std::string source = stream.str();
+        const size_t start = source.find( name + "[" );
+        TEST_CHECK( start != std::string::npos );
+        const size_t open = source.find( '{', start );
+        const size_t close = source.find( '}', open );
+        TEST_CHECK( open != std::string::npos && close != std::string::npos );
+        std::string values = source.substr( open + 1, close - open - 1 );
+        std::replace( values.begin(), values.end(), ',', ' ' );
+        std::stringstream valueStream( values );
+        std::vector< float > result;
+        float value = 0;
+        while( valueStream >> value ) result.push_back( value );
+        return result;
+    }
+
+    //Compiles and links the shader, binding position to location 0 as ofShader::bindDefaults does
+    static GLuint createProgram( const std::string &vertexSource, const std::string &fragmentSource ){
+        GLuint program = glCreateProgram();
+        glAttachShader( program, compileShader( GL_VERTEX_SHADER, vertexSource ) );
+        glAttachShader( program, compileShader( GL_FRAGMENT_SHADER, fragmentSource ) );
+        glBindAttribLocation( program, 0, "position" );
+        glLinkProgram( program );
+        GLint status = GL_FALSE;
+        glGetProgramiv( program, GL_LINK_STATUS, &status );
+        if( status != GL_TRUE ){
+            char log[1024];
+            glGetProgramInfoLog( program, sizeof(log), NULL, log );
+            fprintf( stderr, "link failed: %s\n", log );
+        }
+        TEST_CHECK( status == GL_TRUE );
+        return program;
+    }
+
+    //Sets the same top-left origin orthographic projection as the openFrameworks default view
+    void setScreenProjection( const GLuint program ) const {
+        const float m[16] = { 2.0f/width,0,0,0, 0,-2.0f/height,0,0, 0,0,-1,0, -1,1,0,1 };
+        glUniformMatrix4fv( glGetUniformLocation( program, "modelViewProjectionMatrix" ), 1, GL_FALSE, m );
+    }
+
+    void clear(){
+        glClearColor( 0, 0, 0, 0 );
+        glClear( GL_COLOR_BUFFER_BIT );
+    }
+
+    void readPixels(){
+        glFinish();
+        glReadPixels( 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0] );
+        TEST_CHECK( glGetError() == GL_NO_ERROR );
+    }
+
+    //Returns the red channel of the pixel at (x,y), with y measured from the top like the plots
+    unsigned char getRed( const int x, const int y ) const {
+        return pixels[ ((height-1-y)*width + x)*4 ];
+    }
+
+    //Returns the number of pixels in column x with a non-zero red channel, and the mean row of those pixels
+    int getColumnCoverage( const int x, float &meanY ) const {
+        int count = 0;
+        meanY = 0;
+        for(int y=0; y<height; y++){
+            if( getRed( x, y ) > 0 ){ count++; meanY += y; }
+        }
+        if( count > 0 ) meanY /= count;
+        return count;
+    }
+
+    const int width;
+    const int height;
+
+protected:
+    static GLuint compileShader( const GLenum type, const std::string &source ){
+        GLuint shader = glCreateShader( type );
+        const char *text = source.c_str();
+        glShaderSource( shader, 1, &text, NULL );
+        glCompileShader( shader );
+        GLint status = GL_FALSE;
+        glGetShaderiv( shader, GL_COMPILE_STATUS, &status );
+        if( status != GL_TRUE ){
+            char log[1024];
+            glGetShaderInfoLog( shader, sizeof(log), NULL, log );
+            fprintf( stderr, "compile failed: %s\n", log );
+        }
+        TEST_CHECK( status == GL_TRUE );
+        return shader;
+    }
+
+    EGLDisplay display;
+    EGLContext context;
+    GLuint framebuffer;
+    GLuint colorBuffer;
+    std::vector< unsigned char > pixels;
+};
+
+#endif //OFX_GRT_TEST_GL_HEADER
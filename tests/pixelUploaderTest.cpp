@@ -0,0 +1,67 @@
+/**
+ Headless check of the GL path ofxGrtPixelUploader relies on. Two pixel buffers are used in turn, each is mapped with
+ GL_MAP_INVALIDATE_BUFFER_BIT, written in place (as map/commit lets a producer do), unmapped and uploaded to the texture
+ from the bound buffer. The texture is read back after every upload to check it holds the frame that was just written.
+ */
+
+#include "ofxGrtTestGL.h"
+
+static const int WIDTH = 64;
+static const int HEIGHT = 48;
+
+int main(){
+    ofxGrtTestGL gl( WIDTH, HEIGHT );
+
+    GLuint texture = 0;
+    glGenTextures( 1, &texture );
+    glBindTexture( GL_TEXTURE_2D, texture );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA32F, WIDTH, HEIGHT, 0, GL_RGBA, GL_FLOAT, NULL );
+    glBindTexture( GL_TEXTURE_2D, 0 );
+
+    GLuint readFramebuffer = 0;
+    glGenFramebuffers( 1, &readFramebuffer );
+    glBindFramebuffer( GL_READ_FRAMEBUFFER, readFramebuffer );
+    glFramebufferTexture2D( GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0 );
+    TEST_CHECK( glCheckFramebufferStatus( GL_READ_FRAMEBUFFER ) == GL_FRAMEBUFFER_COMPLETE );
+
+    GLuint buffers[2];
+    glGenBuffers( 2, buffers );
+    const size_t size = WIDTH * HEIGHT * 4 * sizeof(float);
+    std::vector< float > readback( WIDTH * HEIGHT * 4 );
+
+    unsigned int writeIndex = 0;
+    for(int frame=0; frame<8; frame++){
+        //map: allocate the buffer the first time, then map it invalidated so the driver never waits for the previous transfer
+        glBindBuffer( GL_PIXEL_UNPACK_BUFFER, buffers[ writeIndex ] );
+        if( frame < 2 ) glBufferData( GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW );
+        float *pixels = (float*)glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT );
+        TEST_CHECK( pixels != NULL );
+
+        //The producer writes every pixel straight into the mapped buffer
+        for(int i=0; i<WIDTH*HEIGHT; i++){
+            pixels[i*4+0] = (float)frame;
+            pixels[i*4+1] = (float)(i % WIDTH);
+            pixels[i*4+2] = (float)(i / WIDTH);
+            pixels[i*4+3] = 1.0f;
+        }
+
+        //commit: unmap and upload from the bound buffer, which only queues the transfer
+        TEST_CHECK( glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER ) == GL_TRUE );
+        glBindTexture( GL_TEXTURE_2D, texture );
+        glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, WIDTH, HEIGHT, GL_RGBA, GL_FLOAT, 0 );
+        glBindTexture( GL_TEXTURE_2D, 0 );
+        glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+        writeIndex = 1 - writeIndex;
+        TEST_CHECK( glGetError() == GL_NO_ERROR );
+
+        glReadPixels( 0, 0, WIDTH, HEIGHT, GL_RGBA, GL_FLOAT, &readback[0] );
+        for(int i=0; i<WIDTH*HEIGHT; i++){
+            TEST_CHECK( readback[i*4+0] == (float)frame );
+            TEST_CHECK( readback[i*4+1] == (float)(i % WIDTH) );
+            TEST_CHECK( readback[i*4+2] == (float)(i / WIDTH) );
+        }
+    }
+
+    printf( "pixelUploaderTest passed\n" );
+    return EXIT_SUCCESS;
+}
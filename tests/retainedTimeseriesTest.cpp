@@ -0,0 +1,181 @@
+/**
+ Check of the ofxGrtTimeseriesPlot retained renderer. The vbo contents come from ofxGrtRingMirror, the same code uploadPendingSamples() runs,
+ only the ofBufferObject::updateData calls are replaced by glBufferSubData. The first part checks, for every head position and number of pending
+ samples of a small ring, that the partial update leaves the mirror identical to a full rebuild. The second part draws the mirror headless with the
+ retained shader from the addon source, starting at getFirstVertex, and compares the rendered lines against where the plot should put them.
+ The ofVbo setup and the draw loop of drawRetainedTimeseries() are mirrored here by hand, they are not covered.
+ */
+
+#include "ofxGrtTestGL.h"
+#include "../src/ofxGrtRingMirror.h"
+#include <cmath>
+
+static const int PLOT_WIDTH = 200;
+static const int PLOT_HEIGHT = 100;
+static const unsigned int L = 100;
+static const unsigned int NUM_CHANNELS = 2;
+
+//Applies the mirror writes to a copy of the mirror in memory
+struct MemoryWriter{
+    MemoryWriter( std::vector< float > &mirror ) : mirror( mirror ), numWrites( 0 ) {}
+    void write( const size_t offset, const unsigned int count, const float *data ){
+        TEST_CHECK( offset + count <= mirror.size() );
+        std::copy( data, data + count, mirror.begin() + offset );
+        numWrites++;
+    }
+    std::vector< float > &mirror;
+    unsigned int numWrites;
+};
+
+//Applies the mirror writes to the bound array buffer, as ofBufferObject::updateData does
+struct BufferWriter{
+    void write( const size_t offset, const unsigned int count, const float *data ){
+        glBufferSubData( GL_ARRAY_BUFFER, offset*sizeof(float), count*sizeof(float), data );
+    }
+};
+
+//Writes a sample to every channel at the head and advances it, as the plot does
+static void pushSample( ofxGrtSampleBuffer &buffer, unsigned int &head, const float value ){
+    for(unsigned int j=0; j<buffer.getNumChannels(); j++) buffer.set( j, head, value + j*1000 );
+    head = head + 1 < buffer.getLength() ? head + 1 : 0;
+}
+
+//For every head and every number of pending samples (including more than the ring holds) the updated mirror must match a full rebuild
+static void testUpdateRuns( const ofxGrtSampleFormat format ){
+    const unsigned int length = 13;
+    unsigned long long numChecks = 0;
+    for(unsigned int head=0; head<length; head++){
+        for(unsigned int numPending=0; numPending<=length+3; numPending++){
+            ofxGrtSampleBuffer buffer;
+            buffer.setup( format, 3, length, 0 );
+            unsigned int bufferHead = 0;
+            for(unsigned int i=0; i<head+length; i++) pushSample( buffer, bufferHead, (float)(i % 200) );
+            TEST_CHECK( bufferHead == head );
+
+            std::vector< float > mirror, scratch;
+            ofxGrtRingMirror::build( buffer, mirror );
+            for(unsigned int i=0; i<numPending; i++) pushSample( buffer, bufferHead, (float)((i * 7 + 3) % 200) );
+
+            MemoryWriter writer( mirror );
+            ofxGrtRingMirror::update( buffer, bufferHead, numPending, scratch, writer );
+            TEST_CHECK( writer.numWrites <= 4*buffer.getNumChannels() );
+
+            std::vector< float > expected;
+            ofxGrtRingMirror::build( buffer, expected );
+            TEST_CHECK( mirror == expected );
+
+            //Drawing length vertices from the first vertex gives the samples from oldest to newest
+            for(unsigned int j=0; j<buffer.getNumChannels(); j++){
+                const unsigned int firstVertex = ofxGrtRingMirror::getFirstVertex( j, length, bufferHead );
+                for(unsigned int k=0; k<length; k++){
+                    TEST_CHECK( mirror[ firstVertex + k ] == buffer.get( j, (bufferHead + k) % length ) );
+                }
+            }
+            numChecks++;
+        }
+    }
+    printf( "format %d: checked %llu head and pending combinations\n", (int)format, numChecks );
+}
+
+//Returns the row the shader should map value to for a valueRange of [-1 2]
+static float expectedRow( const float value ){
+    return PLOT_HEIGHT * (1.0f - (value + 1.0f) / 3.0f);
+}
+
+//Draws every channel as drawRetainedTimeseries() does and checks the left and right halves of the line land on the expected rows
+static void drawAndCheck( ofxGrtTestGL &gl, const GLuint program, const GLuint vao, const unsigned int bufferHead,
+                          const float channelValues[NUM_CHANNELS][2] ){
+    for(unsigned int j=0; j<NUM_CHANNELS; j++){
+        gl.clear();
+        glUseProgram( program );
+        gl.setScreenProjection( program );
+        glUniform1f( glGetUniformLocation( program, "xStart" ), 0 );
+        glUniform1f( glGetUniformLocation( program, "xStep" ), PLOT_WIDTH / (float)L );
+        glUniform1f( glGetUniformLocation( program, "plotHeight" ), PLOT_HEIGHT );
+        glUniform1i( glGetUniformLocation( program, "constrainValues" ), 1 );
+        const int firstVertex = ofxGrtRingMirror::getFirstVertex( j, L, bufferHead );
+        glUniform1i( glGetUniformLocation( program, "firstVertex" ), firstVertex );
+        glUniform2f( glGetUniformLocation( program, "valueRange" ), -1, 2 );
+        glUniform4f( glGetUniformLocation( program, "lineColor" ), 1, 0, 0, 1 );
+        glBindVertexArray( vao );
+        glDrawArrays( GL_LINE_STRIP, firstVertex, L );
+        glBindVertexArray( 0 );
+        gl.readPixels();
+
+        float meanY = 0;
+        TEST_CHECK( gl.getColumnCoverage( PLOT_WIDTH/4, meanY ) > 0 );
+        TEST_CHECK( fabs( meanY - expectedRow( channelValues[j][0] ) ) <= 1.5f );
+        TEST_CHECK( gl.getColumnCoverage( 3*PLOT_WIDTH/4, meanY ) > 0 );
+        TEST_CHECK( fabs( meanY - expectedRow( channelValues[j][1] ) ) <= 1.5f );
+    }
+}
+
+//Fills the ring so the first half of the window holds first and the second half holds second, for each channel
+static void fillHalves( ofxGrtSampleBuffer &buffer, unsigned int &head, const float values[NUM_CHANNELS][2] ){
+    for(unsigned int k=0; k<L; k++){
+        for(unsigned int j=0; j<NUM_CHANNELS; j++) buffer.set( j, head, values[j][ k < L/2 ? 0 : 1 ] );
+        head = head + 1 < L ? head + 1 : 0;
+    }
+}
+
+static void testDraw(){
+    ofxGrtTestGL gl( PLOT_WIDTH, PLOT_HEIGHT );
+    const GLuint program = ofxGrtTestGL::createProgram(
+        ofxGrtTestGL::loadShaderSource( "../src/ofxGrtTimeseriesPlot.cpp", "retainedVertexShader" ),
+        ofxGrtTestGL::loadShaderSource( "../src/ofxGrtTimeseriesPlot.cpp", "retainedFragmentShader" ) );
+
+    //The head starts mid buffer so the oldest samples wrap around the end of the first copy
+    ofxGrtSampleBuffer buffer;
+    buffer.setup( OFXGRT_SAMPLE_FLOAT, NUM_CHANNELS, L, 0 );
+    unsigned int bufferHead = 30;
+    const float initialValues[NUM_CHANNELS][2] = { {0,1}, {1.5f,-0.5f} };
+    fillHalves( buffer, bufferHead, initialValues );
+
+    //The vbo is created from the full mirror, the same data setVertexData( &vboScratch[0], 1, ... ) uploads
+    std::vector< float > mirror, scratch;
+    ofxGrtRingMirror::build( buffer, mirror );
+    GLuint vao = 0, vbo = 0;
+    glGenVertexArrays( 1, &vao );
+    glGenBuffers( 1, &vbo );
+    glBindVertexArray( vao );
+    glBindBuffer( GL_ARRAY_BUFFER, vbo );
+    glBufferData( GL_ARRAY_BUFFER, mirror.size()*sizeof(float), &mirror[0], GL_DYNAMIC_DRAW );
+    glEnableVertexAttribArray( 0 );
+    glVertexAttribPointer( 0, 1, GL_FLOAT, GL_FALSE, sizeof(float), 0 );
+    glBindVertexArray( 0 );
+    TEST_CHECK( glGetError() == GL_NO_ERROR );
+
+    drawAndCheck( gl, program, vao, bufferHead, initialValues );
+
+    //Push half a buffer of new samples, the update wraps around the end of the ring
+    const float newValues[NUM_CHANNELS] = { 0, 1.5f };
+    for(unsigned int k=0; k<L/2; k++){
+        for(unsigned int j=0; j<NUM_CHANNELS; j++) buffer.set( j, bufferHead, newValues[j] );
+        bufferHead = bufferHead + 1 < L ? bufferHead + 1 : 0;
+    }
+    BufferWriter writer;
+    glBindBuffer( GL_ARRAY_BUFFER, vbo );
+    ofxGrtRingMirror::update( buffer, bufferHead, L/2, scratch, writer );
+    TEST_CHECK( glGetError() == GL_NO_ERROR );
+
+    const float updatedValues[NUM_CHANNELS][2] = { {1,0}, {-0.5f,1.5f} };
+    drawAndCheck( gl, program, vao, bufferHead, updatedValues );
+
+    //Refill the whole ring, as setData does, the existing buffer is refreshed in place
+    const float refilledValues[NUM_CHANNELS][2] = { {-0.5f,0.5f}, {1,0} };
+    fillHalves( buffer, bufferHead, refilledValues );
+    glBindBuffer( GL_ARRAY_BUFFER, vbo );
+    ofxGrtRingMirror::update( buffer, bufferHead, L, scratch, writer );
+    TEST_CHECK( glGetError() == GL_NO_ERROR );
+
+    drawAndCheck( gl, program, vao, bufferHead, refilledValues );
+}
+
+int main(){
+    testUpdateRuns( OFXGRT_SAMPLE_FLOAT );
+    testUpdateRuns( OFXGRT_SAMPLE_INT16 );
+    testUpdateRuns( OFXGRT_SAMPLE_UINT8 );
+    testDraw();
+    printf( "retainedTimeseriesTest passed\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+/**
+ Stress test for ofxGrtSnapshotBuffer and ofxGrtProducerGate, build it with -fsanitize=thread to check for data races.
+ A producer thread publishes numbered frames while the consumer acquires them. Every frame must be read whole and never older
+ than the frame before it, and the last frame must be the last one published. A second run reallocates the buffer behind the
+ gate while the producer is still publishing, as ofxGrtBarPlot::setup and setLockFreeUpdates do.
+ */
+
+#include "../src/ofxGrtSnapshotBuffer.h"
+#include "../src/ofxGrtProducerGate.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#define TEST_CHECK( cond ) do{ if( !(cond) ){ fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond ); exit( EXIT_FAILURE ); } }while(0)
+
+static const unsigned int FRAME_SIZE = 256;
+static const int NUM_FRAMES = 200000;
+
+//Checks the frame is whole (every value comes from the same publish) and not older than the last frame
+static void checkFrame( const float *frame, const unsigned int frameSize, float &lastValue ){
+    for(unsigned int n=1; n<frameSize; n++) TEST_CHECK( frame[n] == frame[0] );
+    TEST_CHECK( frame[0] >= lastValue );
+    lastValue = frame[0];
+}
+
+//Writes a frame filled with value and publishes it, the same steps as ofxGrtBarPlot::publishFrame
+static void publishFrame( ofxGrtSnapshotBuffer &snapshot, const float value ){
+    float *frame = snapshot.getWriteFrame();
+    for(unsigned int n=0; n<snapshot.getFrameSize(); n++) frame[n] = value;
+    snapshot.publish();
+}
+
+static void testTornReads(){
+    ofxGrtSnapshotBuffer snapshot;
+    snapshot.setup( FRAME_SIZE );
+
+    std::atomic< bool > done( false );
+    std::thread producer( [&](){
+        for(int i=1; i<=NUM_FRAMES; i++) publishFrame( snapshot, (float)i );
+        done = true;
+    } );
+
+    float lastValue = 0;
+    unsigned long long numRead = 0;
+    while( !done ){
+        if( snapshot.acquire() ){ checkFrame( snapshot.getReadFrame(), FRAME_SIZE, lastValue ); numRead++; }
+    }
+    producer.join();
+    if( snapshot.acquire() ){ checkFrame( snapshot.getReadFrame(), FRAME_SIZE, lastValue ); numRead++; }
+
+    printf( "read %llu of %d frames, last %d\n", numRead, NUM_FRAMES, (int)lastValue );
+    TEST_CHECK( lastValue == NUM_FRAMES );
+}
+
+static void testReallocation(){
+    ofxGrtSnapshotBuffer snapshot;
+    ofxGrtProducerGate gate;
+    snapshot.setup( FRAME_SIZE );
+    gate.open();
+
+    std::atomic< bool > done( false );
+    std::thread producer( [&](){
+        for(int i=1; i<=NUM_FRAMES; i++){
+            if( gate.enter() ){
+                publishFrame( snapshot, (float)i );
+                gate.leave();
+            }
+        }
+        done = true;
+    } );
+
+    //The consumer draws and reallocates from the same thread, as draw and setup are serialized by the plot mutex
+    unsigned int numReallocations = 0;
+    while( !done ){
+        float lastValue = 0;
+        for(int k=0; k<16; k++){
+            if( gate.getIsOpen() && snapshot.acquire() ) checkFrame( snapshot.getReadFrame(), snapshot.getFrameSize(), lastValue );
+        }
+        gate.close();
+        snapshot.setup( FRAME_SIZE + numReallocations % 16 );
+        gate.open();
+        numReallocations++;
+    }
+    producer.join();
+    printf( "reallocated the snapshot %u times while the producer was running\n", numReallocations );
+}
+
+int main(){
+    testTornReads();
+    testReallocation();
+    printf( "snapshotStressTest passed\n" );
+    return EXIT_SUCCESS;
+}